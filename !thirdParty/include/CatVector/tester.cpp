@@ -1,6 +1,8 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -17,6 +19,21 @@ class test {
   [[maybe_unused]] void print() { std::cout << " " << a << " " << b << " " << c << std::endl; }
 };
 
+// Owns heap memory, so not trivially copyable, but nothing points back into the object and
+// moving its bytes is safe
+struct handle {
+  std::unique_ptr<int> value;
+  [[maybe_unused]] handle() = default;
+  [[maybe_unused]] explicit handle(int v) : value(std::make_unique<int>(v)) {}
+};
+
+template <>
+struct lni::is_trivially_relocatable<handle> : std::true_type {};
+
+static_assert(lni::is_trivially_relocatable_v<test>);
+static_assert(!lni::is_trivially_relocatable_v<std::string>);
+static_assert(lni::is_trivially_relocatable_v<handle>);
+
 int main() {
   int i;
   time_t st;
@@ -221,6 +238,57 @@ int main() {
   lni::Print(v9, "v9");
   for (auto &n : v9) std::cout << " " << n;
   std::cout << std::endl;
+
+  std::cout << "\nTesting std::string elements ... " << std::endl;
+  lni::vector<std::string> vs;
+  for (i = 0; i < 6; ++i) vs.push_back(std::string(20, static_cast<char>('a' + i)));
+  vs.insert(vs.begin(), "first element, too long for the small string buffer");
+  vs.erase(vs.begin() + 2, vs.begin() + 4);
+  vs.resize(4);
+  for (const auto &str : vs) std::cout << " " << str << std::endl;
+  std::cout << " size: " << vs.size() << std::endl;
+
+  std::cout << "Testing opt-in relocatable elements ... " << std::endl;
+  lni::vector<handle> vh;
+  for (i = 0; i < 10; ++i) vh.emplace_back(i);
+  vh.emplace(vh.begin(), -1);
+  vh.erase(vh.begin() + 1);
+  std::cout << " vh:";
+  for (const auto &h : vh) std::cout << " " << *h.value;
+  std::cout << std::endl;
+
+  std::cout << "Testing vector(0) then push_back ... " << std::endl;
+  lni::vector<int> v10(0);
+  v10.push_back(42);
+  std::cout << " v10: " << v10[0] << ", size: " << v10.size() << std::endl;
+
+  std::cout << "Testing assign(initializer_list) ... " << std::endl;
+  v10.assign({1, 2, 3});
+  std::cout << " v10:";
+  for (const auto &n : v10) std::cout << " " << n;
+  std::cout << ", size: " << v10.size() << std::endl;
+
+  std::cout << "Testing move constructor and move assignment ... " << std::endl;
+  const std::string *moved_data = vs.data();
+  lni::vector<std::string> vs_moved(std::move(vs));
+  std::cout << " buffer taken: " << (vs_moved.data() == moved_data) << ", source size: "
+            << vs.size() << ", size: " << vs_moved.size() << std::endl;
+  lni::vector<std::string> vs_assigned = {"replaced"};
+  vs_assigned = std::move(vs_moved);
+  std::cout << " buffer taken: " << (vs_assigned.data() == moved_data)
+            << ", source size: " << vs_moved.size() << ", first: " << vs_assigned[0].substr(0, 5)
+            << std::endl;
+  vs.push_back("reused after move");
+  std::cout << " moved from vector reused: " << vs[0] << std::endl;
+
+  std::cout << "Testing insert with reallocation ... " << std::endl;
+  lni::vector<std::string> vr = {"x", "y", "z"};
+  vr.shrink_to_fit();
+  auto cap = vr.capacity();
+  vr.insert(vr.begin() + 1, vr.back());  // The value lives in the buffer being replaced
+  std::cout << " reallocated: " << (vr.capacity() > cap) << ", vr:";
+  for (const auto &str : vr) std::cout << " " << str;
+  std::cout << std::endl;
 #endif
 
   st = clock();
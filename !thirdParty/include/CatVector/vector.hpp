@@ -1,9 +1,13 @@
 #include <cstddef>
 #include <cstring>
+#include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #ifndef CATZ_VECTOR
@@ -12,6 +16,17 @@
 
 namespace lni {
 
+// Types whose objects may be moved to another address with memmove, leaving nothing to
+// destroy behind. True for trivially copyable types (built-ins, plain structs such as vertex
+// data), other types whose state does not point into themselves can opt in:
+//   template <>
+//   struct lni::is_trivially_relocatable<Texture> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 template <typename T>
 class vector {
  public:
@@ -38,7 +53,7 @@ class vector {
   vector(vector<T> &&) noexcept;
   ~vector();
   vector<T> &operator=(const vector<T> &);
-  vector<T> &operator=(vector<T> &&);
+  vector<T> &operator=(vector<T> &&) noexcept;
   vector<T> &operator=(std::initializer_list<T>);
   void assign(size_type, const T &value);
   void assign(typename vector<T>::iterator, typename vector<T>::iterator);
@@ -110,149 +125,139 @@ class vector {
   friend void Print(const vector<T> &v, const std::string &vec_name);
 
  private:
-  size_type rsrv_sz = 4;
+  // Slots [0, vec_sz) hold objects, [vec_sz, rsrv_sz) are raw storage
+  size_type rsrv_sz = 0;
   size_type vec_sz = 0;
-  T *arr;
+  T *arr = nullptr;
 
-  void resizeBase(size_type);
-  void resizeBase(size_type sz, const T &c);
+  static T *allocate(size_type);
+  static void deallocate(T *) noexcept;
+  static void destroy(T *, T *) noexcept;
+  static void relocate(T *, T *, size_type);
   inline void reallocate();
+  inline void grow();
 };
 
 template <typename T>
-inline vector<T>::vector() noexcept {
-  arr = new T[rsrv_sz];
-}
+inline vector<T>::vector() noexcept {}
 
 template <typename T>
 inline vector<T>::vector(typename vector<T>::size_type n) {
-  size_type i;
   rsrv_sz = n << 2;
-  arr = new T[rsrv_sz];
-  for (i = 0; i < n; ++i) arr[i] = T();
-  vec_sz = n;
+  arr = allocate(rsrv_sz);
+  for (; vec_sz < n; ++vec_sz) new (arr + vec_sz) T();
 }
 
 template <typename T>
 inline vector<T>::vector(typename vector<T>::size_type n, const T &value) {
-  size_type i;
   rsrv_sz = n << 2;
-  arr = new T[rsrv_sz];
-  for (i = 0; i < n; ++i) arr[i] = value;
-  vec_sz = n;
+  arr = allocate(rsrv_sz);
+  for (; vec_sz < n; ++vec_sz) new (arr + vec_sz) T(value);
 }
 
 template <typename T>
 inline vector<T>::vector(typename vector<T>::iterator first, typename vector<T>::iterator last) {
-  size_type i, count = last - first;
+  size_type count = static_cast<size_type>(last - first);
   rsrv_sz = count << 2;
-  arr = new T[rsrv_sz];
-  for (i = 0; i < count; ++i, ++first) arr[i] = *first;
-  vec_sz = count;
+  arr = allocate(rsrv_sz);
+  for (; vec_sz < count; ++vec_sz, ++first) new (arr + vec_sz) T(*first);
 }
 
 template <typename T>
 inline vector<T>::vector(std::initializer_list<T> lst) {
   rsrv_sz = lst.size() << 2;
-  arr = new T[rsrv_sz];
-  for (auto &item : lst) arr[vec_sz++] = item;
+  arr = allocate(rsrv_sz);
+  for (auto &item : lst) new (arr + vec_sz++) T(item);
 }
 
 template <typename T>
 inline vector<T>::vector(const vector<T> &other) {
-  size_type i;
   rsrv_sz = other.rsrv_sz;
-  arr = new T[rsrv_sz];
-  for (i = 0; i < other.vec_sz; ++i) arr[i] = other.arr[i];
-  vec_sz = other.vec_sz;
+  arr = allocate(rsrv_sz);
+  for (; vec_sz < other.vec_sz; ++vec_sz) new (arr + vec_sz) T(other.arr[vec_sz]);
 }
 
 template <typename T>
-inline vector<T>::vector(vector<T> &&other) noexcept {
-  size_type i;
-  rsrv_sz = other.rsrv_sz;
-  arr = new T[rsrv_sz];
-  for (i = 0; i < other.vec_sz; ++i) arr[i] = std::move(other.arr[i]);
-  vec_sz = other.vec_sz;
+inline vector<T>::vector(vector<T> &&other) noexcept
+    : rsrv_sz(other.rsrv_sz), vec_sz(other.vec_sz), arr(other.arr) {
+  other.rsrv_sz = 0;
+  other.vec_sz = 0;
+  other.arr = nullptr;
 }
 
 template <typename T>
 inline vector<T>::~vector() {
-  if (arr) {
-    delete[] arr;
-  }
+  destroy(arr, arr + vec_sz);
+  deallocate(arr);
 }
 
 template <typename T>
 inline vector<T> &vector<T>::operator=(const vector<T> &other) {
-  size_type i;
+  if (this == &other) return *this;
+  clear();
   if (rsrv_sz < other.vec_sz) {
     rsrv_sz = other.vec_sz << 2;
     reallocate();
   }
-  for (i = 0; i < other.vec_sz; ++i) arr[i] = other.arr[i];
-  vec_sz = other.vec_sz;
+  for (; vec_sz < other.vec_sz; ++vec_sz) new (arr + vec_sz) T(other.arr[vec_sz]);
 
   return *this;
 }
 
 template <typename T>
-inline vector<T> &vector<T>::operator=(vector<T> &&other) {
-  size_type i;
-  if (rsrv_sz < other.vec_sz) {
-    rsrv_sz = other.vec_sz << 2;
-    reallocate();
-  }
-  for (i = 0; i < other.vec_sz; ++i) arr[i] = std::move(other.arr[i]);
+inline vector<T> &vector<T>::operator=(vector<T> &&other) noexcept {
+  if (this == &other) return *this;
+  destroy(arr, arr + vec_sz);
+  deallocate(arr);
+  rsrv_sz = other.rsrv_sz;
   vec_sz = other.vec_sz;
+  arr = other.arr;
+  other.rsrv_sz = 0;
+  other.vec_sz = 0;
+  other.arr = nullptr;
 
   return *this;
 }
 
 template <typename T>
 inline vector<T> &vector<T>::operator=(std::initializer_list<T> lst) {
-  if (rsrv_sz < lst.size()) {
-    rsrv_sz = lst.size() << 2;
-    reallocate();
-  }
-  vec_sz = 0;
-  for (auto &item : lst) arr[vec_sz++] = item;
+  assign(lst);
 
   return *this;
 }
 
 template <typename T>
 inline void vector<T>::assign(typename vector<T>::size_type count, const T &value) {
-  size_type i;
+  T copy(value);  // value may be one of the elements cleared below
+  clear();
   if (count > rsrv_sz) {
     rsrv_sz = count << 2;
     reallocate();
   }
-  for (i = 0; i < count; ++i) arr[i] = value;
-  vec_sz = count;
+  for (; vec_sz < count; ++vec_sz) new (arr + vec_sz) T(copy);
 }
 
 template <typename T>
 inline void vector<T>::assign(
     typename vector<T>::iterator first, typename vector<T>::iterator last) {
-  size_type i, count = static_cast<size_type>(last - first);
+  size_type count = static_cast<size_type>(last - first);
+  clear();
   if (count > rsrv_sz) {
     rsrv_sz = count << 2;
     reallocate();
   }
-  for (i = 0; i < count; ++i, ++first) arr[i] = *first;
-  vec_sz = count;
+  for (; vec_sz < count; ++vec_sz, ++first) new (arr + vec_sz) T(*first);
 }
 
 template <typename T>
 inline void vector<T>::assign(std::initializer_list<T> lst) {
-  size_type i, count = lst.size();
+  size_type count = lst.size();
+  clear();
   if (count > rsrv_sz) {
     rsrv_sz = count << 2;
     reallocate();
   }
-  i = 0;
-  for (auto &item : lst) arr[++i] = item;
+  for (auto &item : lst) new (arr + vec_sz++) T(item);
 }
 
 template <typename T>
@@ -305,14 +310,58 @@ inline typename vector<T>::const_reverse_iterator vector<T>::crend() const noexc
   return reverse_iterator(arr);
 }
 
+template <typename T>
+inline T *vector<T>::allocate(typename vector<T>::size_type n) {
+  if (n == 0) return nullptr;
+  return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+}
+
+template <typename T>
+inline void vector<T>::deallocate(T *p) noexcept {
+  ::operator delete(p, std::align_val_t(alignof(T)));
+}
+
+template <typename T>
+inline void vector<T>::destroy(T *first, T *last) noexcept {
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (; first != last; ++first) first->~T();
+  }
+}
+
+// Moves n objects from src to dst, the ranges may overlap. The objects left at src are
+// destroyed, dst must be raw storage apart from the overlap.
+template <typename T>
+inline void vector<T>::relocate(T *dst, T *src, typename vector<T>::size_type n) {
+  if (n == 0 || dst == src) return;
+  if constexpr (is_trivially_relocatable_v<T>) {
+    std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+  } else if (dst < src) {
+    for (size_type i = 0; i < n; ++i) {
+      new (dst + i) T(std::move(src[i]));
+      src[i].~T();
+    }
+  } else {
+    for (size_type i = n; i-- > 0;) {
+      new (dst + i) T(std::move(src[i]));
+      src[i].~T();
+    }
+  }
+}
+
 template <typename T>
 inline void vector<T>::reallocate() {
-  T *tarr = new (std::nothrow) T[rsrv_sz];
-  memcpy(tarr, arr, vec_sz * sizeof(T));
-  delete[] arr;
+  T *tarr = allocate(rsrv_sz);
+  relocate(tarr, arr, vec_sz);
+  deallocate(arr);
   arr = tarr;
 }
 
+template <typename T>
+inline void vector<T>::grow() {
+  rsrv_sz = rsrv_sz ? rsrv_sz << 2 : 4;
+  reallocate();
+}
+
 template <typename T>
 inline bool vector<T>::empty() const noexcept {
   return vec_sz == 0;
@@ -340,27 +389,26 @@ inline void vector<T>::resize(typename vector<T>::size_type sz) {
       rsrv_sz = sz;
       reallocate();
     }
+    for (; vec_sz < sz; ++vec_sz) new (arr + vec_sz) T();
   } else {
-    size_type i;
-    for (i = vec_sz; i < sz; ++i) arr[i].~T();
+    destroy(arr + sz, arr + vec_sz);
+    vec_sz = sz;
   }
-  vec_sz = sz;
 }
 
 template <typename T>
 inline void vector<T>::resize(typename vector<T>::size_type sz, const T &c) {
   if (sz > vec_sz) {
+    T copy(c);  // c may be one of the elements moved by reallocate
     if (sz > rsrv_sz) {
       rsrv_sz = sz;
       reallocate();
     }
-    size_type i;
-    for (i = vec_sz; i < sz; ++i) arr[i] = c;
+    for (; vec_sz < sz; ++vec_sz) new (arr + vec_sz) T(copy);
   } else {
-    size_type i;
-    for (i = vec_sz; i < sz; ++i) arr[i].~T();
+    destroy(arr + sz, arr + vec_sz);
+    vec_sz = sz;
   }
-  vec_sz = sz;
 }
 
 template <typename T>
@@ -440,151 +488,112 @@ template <typename T>
 template <class... Args>
 inline void vector<T>::emplace_back(Args &&...args) {
   if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
+    T value(std::forward<Args>(args)...);  // args may refer to elements moved by grow
+    grow();
+    new (arr + vec_sz) T(std::move(value));
+  } else {
+    new (arr + vec_sz) T(std::forward<Args>(args)...);
   }
-  arr[vec_sz] = std::move(T(std::forward<Args>(args)...));
   ++vec_sz;
 }
 
 template <typename T>
 inline void vector<T>::push_back(const T &val) {
-  if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
-  }
-  arr[vec_sz] = val;
-  ++vec_sz;
+  emplace_back(val);
 }
 
 template <typename T>
 inline void vector<T>::push_back(T &&val) {
-  if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
-  }
-  arr[vec_sz] = std::move(val);
-  ++vec_sz;
+  emplace_back(std::move(val));
 }
 
 template <typename T>
 inline void vector<T>::pop_back() {
   --vec_sz;
-  arr[vec_sz].~T();
+  destroy(arr + vec_sz, arr + vec_sz + 1);
 }
 
 template <typename T>
 template <class... Args>
 inline typename vector<T>::iterator vector<T>::emplace(
     typename vector<T>::const_iterator it, Args &&...args) {
-  iterator iit = &arr[it - arr];
-  if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
-  }
-  memmove(iit + 1, iit, (vec_sz - (it - arr)) * sizeof(T));
-  (*iit) = std::move(T(std::forward<Args>(args)...));
+  size_type idx = static_cast<size_type>(it - arr);
+  T value(std::forward<Args>(args)...);
+  if (vec_sz == rsrv_sz) grow();
+  relocate(arr + idx + 1, arr + idx, vec_sz - idx);
+  new (arr + idx) T(std::move(value));
   ++vec_sz;
-  return iit;
+  return arr + idx;
 }
 
 template <typename T>
 inline typename vector<T>::iterator vector<T>::insert(
     typename vector<T>::const_iterator it, const T &val) {
-  iterator iit = &arr[it - arr];
-  if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
-  }
-  memmove(iit + 1, iit, (vec_sz - (it - arr)) * sizeof(T));
-  (*iit) = val;
-  ++vec_sz;
-  return iit;
+  return emplace(it, val);
 }
 
 template <typename T>
 inline typename vector<T>::iterator vector<T>::insert(
     typename vector<T>::const_iterator it, T &&val) {
-  iterator iit = &arr[it - arr];
-  if (vec_sz == rsrv_sz) {
-    rsrv_sz <<= 2;
-    reallocate();
-  }
-  memmove(iit + 1, iit, (vec_sz - (it - arr)) * sizeof(T));
-  (*iit) = std::move(val);
-  ++vec_sz;
-  return iit;
+  return emplace(it, std::move(val));
 }
+
 template <typename T>
 inline typename vector<T>::iterator vector<T>::insert(
     typename vector<T>::const_iterator it, typename vector<T>::size_type cnt, const T &val) {
-  iterator f = &arr[it - arr];
-  if (!cnt) return f;
+  size_type idx = static_cast<size_type>(it - arr);
+  if (!cnt) return arr + idx;
+  T copy(val);
   if (vec_sz + cnt > rsrv_sz) {
     rsrv_sz = (vec_sz + cnt) << 2;
     reallocate();
   }
-  memmove(f + cnt, f, (vec_sz - (it - arr)) * sizeof(T));
-  vec_sz += cnt;
-  for (iterator cur = f; cnt--; ++cur) (*cur) = val;
-  return f;
+  relocate(arr + idx + cnt, arr + idx, vec_sz - idx);
+  for (iterator cur = arr + idx; cnt--; ++cur, ++vec_sz) new (cur) T(copy);
+  return arr + idx;
 }
 
 template <typename T>
 template <class InputIt>
 inline typename vector<T>::iterator vector<T>::insert(
     typename vector<T>::const_iterator it, InputIt first, InputIt last) {
-  iterator f = &arr[it - arr];
+  size_type idx = static_cast<size_type>(it - arr);
   size_type cnt = static_cast<size_type>(last - first);
-  if (!cnt) return f;
+  if (!cnt) return arr + idx;
   if (vec_sz + cnt > rsrv_sz) {
     rsrv_sz = (vec_sz + cnt) << 2;
     reallocate();
   }
-  memmove(f + cnt, f, (vec_sz - (it - arr)) * sizeof(T));
-  for (iterator cur = f; first != last; ++cur, ++first) (*cur) = *first;
-  vec_sz += cnt;
-  return f;
+  relocate(arr + idx + cnt, arr + idx, vec_sz - idx);
+  for (iterator cur = arr + idx; first != last; ++cur, ++first, ++vec_sz) new (cur) T(*first);
+  return arr + idx;
 }
 
 template <typename T>
 inline typename vector<T>::iterator vector<T>::insert(
     typename vector<T>::const_iterator it, std::initializer_list<T> lst) {
-  size_type cnt = lst.size();
-  iterator f = &arr[it - arr];
-  if (!cnt) return f;
-  if (vec_sz + cnt > rsrv_sz) {
-    rsrv_sz = (vec_sz + cnt) << 2;
-    reallocate();
-  }
-  memmove(f + cnt, f, (vec_sz - (it - arr)) * sizeof(T));
-  iterator iit = f;
-  for (auto &item : lst) {
-    (*iit) = item;
-    ++iit;
-  }
-  vec_sz += cnt;
-  return f;
+  return insert(it, lst.begin(), lst.end());
 }
 
 template <typename T>
 inline typename vector<T>::iterator vector<T>::erase(typename vector<T>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  (*iit).~T();
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(T));
+  size_type idx = static_cast<size_type>(it - arr);
+  destroy(arr + idx, arr + idx + 1);
+  relocate(arr + idx, arr + idx + 1, vec_sz - idx - 1);
   --vec_sz;
-  return iit;
+  return arr + idx;
 }
 
 template <typename T>
 inline typename vector<T>::iterator vector<T>::erase(
     typename vector<T>::const_iterator first, typename vector<T>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  for (; first != last; ++first) (*first).~T();
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(T));
-  vec_sz -= last - first;
-  return f;
+  size_type idx = static_cast<size_type>(first - arr);
+  size_type cnt = static_cast<size_type>(last - first);
+  if (!cnt) return arr + idx;
+  destroy(arr + idx, arr + idx + cnt);
+  relocate(arr + idx, arr + idx + cnt, vec_sz - idx - cnt);
+  vec_sz -= cnt;
+  return arr + idx;
 }
 
 template <typename T>
@@ -603,8 +612,7 @@ inline void vector<T>::swap(vector<T> &rhs) {
 
 template <typename T>
 inline void vector<T>::clear() noexcept {
-  size_type i;
-  for (i = 0; i < vec_sz; ++i) arr[i].~T();
+  destroy(arr, arr + vec_sz);
   vec_sz = 0;
 }
 
@@ -658,608 +666,6 @@ inline bool vector<T>::operator>=(const vector<T> &rhs) const {
   return vec_sz >= rhs.vec_sz;
 }
 
-template <typename T>
-inline void vector<T>::resizeBase(size_type sz) {
-  if (sz > rsrv_sz) {
-    rsrv_sz = sz;
-    reallocate();
-  }
-  vec_sz = sz;
-}
-template <>
-inline void vector<bool>::resize(typename vector<bool>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<signed char>::resize(typename vector<signed char>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<unsigned char>::resize(typename vector<unsigned char>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<char>::resize(typename vector<char>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<short int>::resize(typename vector<short int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<unsigned short int>::resize(typename vector<unsigned short int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<int>::resize(typename vector<int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<unsigned int>::resize(typename vector<unsigned int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<long int>::resize(typename vector<long int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<unsigned long int>::resize(typename vector<unsigned long int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<long long int>::resize(typename vector<long long int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<unsigned long long int>::resize(
-    typename vector<unsigned long long int>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<float>::resize(typename vector<float>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<double>::resize(typename vector<double>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <>
-inline void vector<long double>::resize(typename vector<long double>::size_type sz) {
-  resizeBase(sz);
-}
-
-template <typename T>
-inline void vector<T>::resizeBase(size_type sz, const T &c) {
-  if (sz > vec_sz) {
-    if (sz > rsrv_sz) {
-      rsrv_sz = sz;
-      reallocate();
-    }
-    size_type i;
-    for (i = vec_sz; i < sz; ++i) arr[i] = c;
-  }
-  vec_sz = sz;
-}
-template <>
-inline void vector<bool>::resize(typename vector<bool>::size_type sz, const bool &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<signed char>::resize(
-    typename vector<signed char>::size_type sz, const signed char &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<unsigned char>::resize(
-    typename vector<unsigned char>::size_type sz, const unsigned char &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<char>::resize(typename vector<char>::size_type sz, const char &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<short int>::resize(
-    typename vector<short int>::size_type sz, const short int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<unsigned short int>::resize(
-    typename vector<unsigned short int>::size_type sz, const unsigned short int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<int>::resize(typename vector<int>::size_type sz, const int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<unsigned int>::resize(
-    typename vector<unsigned int>::size_type sz, const unsigned int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<long int>::resize(typename vector<long int>::size_type sz, const long int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<unsigned long int>::resize(
-    typename vector<unsigned long int>::size_type sz, const unsigned long int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<long long int>::resize(
-    typename vector<long long int>::size_type sz, const long long int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<unsigned long long int>::resize(
-    typename vector<unsigned long long int>::size_type sz, const unsigned long long int &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<float>::resize(typename vector<float>::size_type sz, const float &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<double>::resize(typename vector<double>::size_type sz, const double &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<long double>::resize(
-    typename vector<long double>::size_type sz, const long double &c) {
-  resizeBase(sz, c);
-}
-
-template <>
-inline void vector<bool>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<signed char>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<unsigned char>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<char>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<short int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<unsigned short int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<unsigned int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<long int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<unsigned long int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<long long int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<unsigned long long int>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<float>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<double>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline void vector<long double>::pop_back() {
-  --vec_sz;
-}
-
-template <>
-inline typename vector<bool>::iterator vector<bool>::erase(
-    typename vector<bool>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(bool));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<signed char>::iterator vector<signed char>::erase(
-    typename vector<signed char>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(signed char));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<unsigned char>::iterator vector<unsigned char>::erase(
-    typename vector<unsigned char>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(unsigned char));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<char>::iterator vector<char>::erase(
-    typename vector<char>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(char));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<short int>::iterator vector<short int>::erase(
-    typename vector<short int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(short int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<unsigned short int>::iterator vector<unsigned short int>::erase(
-    typename vector<unsigned short int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(unsigned short int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<int>::iterator vector<int>::erase(typename vector<int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<unsigned int>::iterator vector<unsigned int>::erase(
-    typename vector<unsigned int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(unsigned int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<long int>::iterator vector<long int>::erase(
-    typename vector<long int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(long int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<unsigned long int>::iterator vector<unsigned long int>::erase(
-    typename vector<unsigned long int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(unsigned long int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<long long int>::iterator vector<long long int>::erase(
-    typename vector<long long int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(long long int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<unsigned long long int>::iterator vector<unsigned long long int>::erase(
-    typename vector<unsigned long long int>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(unsigned long long int));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<float>::iterator vector<float>::erase(
-    typename vector<float>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(float));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<double>::iterator vector<double>::erase(
-    typename vector<double>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(double));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<long double>::iterator vector<long double>::erase(
-    typename vector<long double>::const_iterator it) {
-  iterator iit = &arr[it - arr];
-  memmove(iit, iit + 1, (vec_sz - (it - arr) - 1) * sizeof(long double));
-  --vec_sz;
-  return iit;
-}
-
-template <>
-inline typename vector<bool>::iterator vector<bool>::erase(
-    typename vector<bool>::const_iterator first, typename vector<bool>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(bool));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<signed char>::iterator vector<signed char>::erase(
-    typename vector<signed char>::const_iterator first,
-    typename vector<signed char>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(signed char));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<unsigned char>::iterator vector<unsigned char>::erase(
-    typename vector<unsigned char>::const_iterator first,
-    typename vector<unsigned char>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(unsigned char));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<char>::iterator vector<char>::erase(
-    typename vector<char>::const_iterator first, typename vector<char>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(char));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<short int>::iterator vector<short int>::erase(
-    typename vector<short int>::const_iterator first,
-    typename vector<short int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(short int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<unsigned short int>::iterator vector<unsigned short int>::erase(
-    typename vector<unsigned short int>::const_iterator first,
-    typename vector<unsigned short int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(unsigned short int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<int>::iterator vector<int>::erase(
-    typename vector<int>::const_iterator first, typename vector<int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<unsigned int>::iterator vector<unsigned int>::erase(
-    typename vector<unsigned int>::const_iterator first,
-    typename vector<unsigned int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(unsigned int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<long long int>::iterator vector<long long int>::erase(
-    typename vector<long long int>::const_iterator first,
-    typename vector<long long int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(long long int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<unsigned long long int>::iterator vector<unsigned long long int>::erase(
-    typename vector<unsigned long long int>::const_iterator first,
-    typename vector<unsigned long long int>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(unsigned long long int));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<float>::iterator vector<float>::erase(
-    typename vector<float>::const_iterator first, typename vector<float>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(float));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<double>::iterator vector<double>::erase(
-    typename vector<double>::const_iterator first, typename vector<double>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(double));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline typename vector<long double>::iterator vector<long double>::erase(
-    typename vector<long double>::const_iterator first,
-    typename vector<long double>::const_iterator last) {
-  iterator f = &arr[first - arr];
-  if (first == last) return f;
-  memmove(f, last, (vec_sz - (last - arr)) * sizeof(long double));
-  vec_sz -= last - first;
-  return f;
-}
-
-template <>
-inline void vector<bool>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<signed char>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<unsigned char>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<char>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<short int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<unsigned short int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<unsigned int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<long int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<unsigned long int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<long long int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<unsigned long long int>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<float>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<double>::clear() noexcept {
-  vec_sz = 0;
-}
-
-template <>
-inline void vector<long double>::clear() noexcept {
-  vec_sz = 0;
-}
-
 template <typename T>
 inline void Print(const vector<T> &v, const std::string &vec_name) {
   for (typename vector<T>::size_type i = 0; i < v.size(); ++i) {
@@ -0,0 +1,325 @@
+#include <ThreadedLoggerForCPP/LoggerThread.h>
+
+#include <ThreadedLoggerForCPP/LoggerUringSink.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Producer side throughput and latency of LoggerThread over a grid of configurations.
+//   logger_bench --threads=1,2,4,8 --sizes=16,128,400 --sinks=null,file,uring,ofstream,console
+//                --modes=shared,per-thread --policies=block,drop-newest
+//                --messages=200000 --pressure=0 --csv=logger_bench.csv
+// Every run logs messages records split over the producer threads, each call is timed on its
+// own. Drain time is how long the logger needs after the last producer returned to write
+// everything and shut down. Sink write p99/max is the worker stall per record inside the
+// sinks and flush p99/max the stall per flush pass, where buffered sinks reach the disk,
+// both from the logger metrics. --pressure=N keeps a thread writing and syncing N MiB chunks next
+// to the log file during every run, to compare the sinks while the disk is busy. Results go
+// to stderr as a table and to the CSV file, the console sink writes to stdout so redirect it
+// when benchmarking it.
+
+struct BenchConfig {
+  std::string sink;
+  LoggerQueueMode mode;
+  LoggerOverflowPolicy policy;
+  int threads;
+  int messageBytes;
+};
+
+struct BenchResult {
+  double throughput = 0;  // Records per second, all producers together
+  LoggerLatencySummary enqueue;
+  LoggerLatencySummary sinkWrite;
+  LoggerLatencySummary sinkFlush;
+  std::uint64_t dropped = 0;
+  double drainMilliseconds = 0;
+};
+
+static std::vector<std::string> splitList(std::string_view text) {
+  std::vector<std::string> items;
+  while (!text.empty()) {
+    std::size_t comma = text.find(',');
+    items.emplace_back(text.substr(0, comma));
+    text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+  }
+  return items;
+}
+
+// What every record cost before LoggerFileWriter: a std::ofstream line ended by std::endl
+class OfstreamSink : public LoggerSink {
+ public:
+  explicit OfstreamSink(const std::string &path) : file(path, std::ios::trunc) {}
+
+  void write(LoggerFormatter &formatter) override { file << formatter.text() << std::endl; }
+
+ private:
+  std::ofstream file;
+};
+
+// Keeps the disk busy with synced writes while a run goes on
+class DiskPressure {
+ public:
+  DiskPressure(const std::string &path, int mebibytes) {
+    if (mebibytes <= 0) {
+      return;
+    }
+    thread = std::thread([this, path, mebibytes] {
+      std::string chunk(static_cast<std::size_t>(mebibytes) << 20, 'p');
+      while (!stop.load(std::memory_order_relaxed)) {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+          return;
+        }
+        std::fwrite(chunk.data(), 1, chunk.size(), file);
+        std::fflush(file);
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+        std::fclose(file);
+      }
+    });
+  }
+
+  ~DiskPressure() {
+    stop.store(true, std::memory_order_relaxed);
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+ private:
+  std::atomic<bool> stop{false};
+  std::thread thread;
+};
+
+static std::unique_ptr<LoggerSink> makeSink(const std::string &name, const std::string &filePath) {
+  if (name == "file") {
+    return std::make_unique<LoggerFileSink>(filePath, true);
+  }
+  if (name == "uring") {
+    auto sink = std::make_unique<LoggerUringFileSink>(filePath, true);
+    if (!sink->usesUring()) {
+      std::cerr << "io_uring unavailable, the uring sink falls back to pwrite" << std::endl;
+    }
+    return sink;
+  }
+  if (name == "ofstream") {
+    return std::make_unique<OfstreamSink>(filePath);
+  }
+  if (name == "console") {
+    return std::make_unique<LoggerConsoleSink>();
+  }
+  return std::make_unique<LoggerNullSink>();
+}
+
+static BenchResult runBench(const BenchConfig &config, int messages, const std::string &filePath) {
+  auto logger = std::make_unique<LoggerThread>();
+  logger->ClearSinks();
+  logger->AddSink(makeSink(config.sink, filePath));
+  logger->SetQueueMode(config.mode);
+  logger->SetOverflowPolicy(config.policy);
+  logger->SetShutdownTimeout(std::chrono::minutes(10));
+  logger->EnableMetrics(true);
+
+  std::string payload(static_cast<std::size_t>(config.messageBytes), 'x');
+  std::vector<std::unique_ptr<LoggerLatencyHistogram>> histograms;
+  for (int t = 0; t < config.threads; ++t) {
+    histograms.push_back(std::make_unique<LoggerLatencyHistogram>());
+  }
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  int perThread = messages / config.threads;
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < config.threads; ++t) {
+    producers.emplace_back([&, t] {
+      static constinit LoggerCallSite site(__FILE__, __LINE__);
+      LoggerLatencyHistogram &histogram = *histograms[t];
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < perThread; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        logger->logAsync(LogLevel::INFO, site, LogLiteral("bench "), i, ' ', payload);
+        auto end = std::chrono::steady_clock::now();
+        histogram.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+      }
+    });
+  }
+  while (ready.load() < config.threads) {
+    std::this_thread::yield();
+  }
+  auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  auto produced = std::chrono::steady_clock::now();
+
+  BenchResult result;
+  result.dropped = logger->DroppedMessages();
+  LoggerThread *stopped = logger.get();
+  stopped->ExitLoggerThread();  // Writes every queued record before returning
+  auto drained = std::chrono::steady_clock::now();
+  LoggerMetricsSnapshot metrics = stopped->GetMetrics();
+  result.sinkWrite = metrics.sinkWrite;
+  result.sinkFlush = metrics.sinkFlush;
+  logger.reset();
+
+  for (int t = 1; t < config.threads; ++t) {
+    histograms[0]->merge(*histograms[t]);
+  }
+  result.enqueue = histograms[0]->summary();
+  std::chrono::duration<double> produceTime = produced - start;
+  result.throughput = static_cast<double>(perThread) * config.threads / produceTime.count();
+  result.drainMilliseconds =
+      std::chrono::duration<double, std::milli>(drained - produced).count();
+  return result;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> threads = {"1", "2", "4", "8"};
+  std::vector<std::string> sizes = {"16", "128", "400"};
+  std::vector<std::string> sinks = {"null", "file"};
+  std::vector<std::string> modes = {"shared", "per-thread"};
+  std::vector<std::string> policies = {"block", "drop-newest"};
+  int messages = 200000;
+  int pressure = 0;
+  std::string csvPath = "logger_bench.csv";
+  std::string filePath = "logger_bench.log";
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg(argv[i]);
+    std::size_t equals = arg.find('=');
+    std::string_view name = arg.substr(0, equals);
+    std::string_view value = equals == std::string_view::npos ? "" : arg.substr(equals + 1);
+    if (name == "--threads") {
+      threads = splitList(value);
+    } else if (name == "--sizes") {
+      sizes = splitList(value);
+    } else if (name == "--sinks") {
+      sinks = splitList(value);
+    } else if (name == "--modes") {
+      modes = splitList(value);
+    } else if (name == "--policies") {
+      policies = splitList(value);
+    } else if (name == "--messages") {
+      messages = std::max(std::stoi(std::string(value)), 1);
+    } else if (name == "--pressure") {
+      pressure = std::max(std::stoi(std::string(value)), 0);
+    } else if (name == "--csv") {
+      csvPath = value;
+    } else if (name == "--log") {
+      filePath = value;
+    } else {
+      std::cerr << "usage: " << argv[0]
+                << " [--threads=1,2,4,8] [--sizes=16,128,400]"
+                   " [--sinks=null,file,uring,ofstream,console]"
+                   " [--modes=shared,per-thread] [--policies=block,drop-newest,drop-oldest]"
+                   " [--messages=N] [--pressure=MiB] [--csv=path] [--log=path]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::ofstream csv(csvPath, std::ios::trunc);
+  if (!csv) {
+    std::cerr << "cannot create " << csvPath << std::endl;
+    return 1;
+  }
+  csv << "sink,queue_mode,overflow_policy,threads,message_bytes,messages,dropped,"
+         "throughput_per_s,enqueue_p50_ns,enqueue_p99_ns,enqueue_p999_ns,enqueue_max_ns,"
+         "drain_ms,sink_p99_ns,sink_max_ns,flush_p99_ns,flush_max_ns,pressure_mib\n";
+  std::fprintf(
+      stderr,
+      "%-8s %-10s %-12s %7s %6s %12s %9s %9s %9s %10s %9s %11s %11s %12s %12s\n",
+      "sink",
+      "mode",
+      "policy",
+      "threads",
+      "bytes",
+      "records/s",
+      "p50 ns",
+      "p99 ns",
+      "p999 ns",
+      "dropped",
+      "drain ms",
+      "sink p99 ns",
+      "sink max ns",
+      "flush p99 ns",
+      "flush max ns");
+
+  for (const auto &sink : sinks) {
+    for (const auto &modeName : modes) {
+      for (const auto &policyName : policies) {
+        for (const auto &threadCount : threads) {
+          for (const auto &size : sizes) {
+            BenchConfig config;
+            config.sink = sink;
+            config.mode =
+                modeName == "per-thread" ? LoggerQueueMode::PER_THREAD : LoggerQueueMode::SHARED;
+            config.policy = policyName == "drop-newest"   ? LoggerOverflowPolicy::DROP_NEWEST
+                            : policyName == "drop-oldest" ? LoggerOverflowPolicy::DROP_OLDEST
+                                                          : LoggerOverflowPolicy::BLOCK;
+            config.threads = std::max(std::stoi(threadCount), 1);
+            config.messageBytes = std::max(std::stoi(size), 0);
+            BenchResult result;
+            {
+              DiskPressure busyDisk(filePath + ".pressure", pressure);
+              result = runBench(config, messages, filePath);
+            }
+
+            csv << sink << ',' << modeName << ',' << policyName << ',' << config.threads << ','
+                << config.messageBytes << ',' << messages / config.threads * config.threads
+                << ',' << result.dropped << ',' << static_cast<std::uint64_t>(result.throughput)
+                << ',' << result.enqueue.p50 << ',' << result.enqueue.p99 << ','
+                << result.enqueue.p999 << ',' << result.enqueue.max << ','
+                << result.drainMilliseconds << ',' << result.sinkWrite.p99 << ','
+                << result.sinkWrite.max << ',' << result.sinkFlush.p99 << ','
+                << result.sinkFlush.max << ',' << pressure << '\n';
+            std::fprintf(
+                stderr,
+                "%-8s %-10s %-12s %7d %6d %12.0f %9llu %9llu %9llu %10llu %9.1f %11llu %11llu "
+                "%12llu %12llu\n",
+                sink.c_str(),
+                modeName.c_str(),
+                policyName.c_str(),
+                config.threads,
+                config.messageBytes,
+                result.throughput,
+                static_cast<unsigned long long>(result.enqueue.p50),
+                static_cast<unsigned long long>(result.enqueue.p99),
+                static_cast<unsigned long long>(result.enqueue.p999),
+                static_cast<unsigned long long>(result.dropped),
+                result.drainMilliseconds,
+                static_cast<unsigned long long>(result.sinkWrite.p99),
+                static_cast<unsigned long long>(result.sinkWrite.max),
+                static_cast<unsigned long long>(result.sinkFlush.p99),
+                static_cast<unsigned long long>(result.sinkFlush.max));
+          }
+        }
+      }
+    }
+  }
+  std::remove(filePath.c_str());
+  std::remove((filePath + ".pressure").c_str());
+  return 0;
+}
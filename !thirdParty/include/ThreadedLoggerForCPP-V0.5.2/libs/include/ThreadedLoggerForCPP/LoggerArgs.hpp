@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+#include <iterator>
+
+#include "LoggerFormat.hpp"
+
+// FORMAT is the pattern of LOGGER_THREAD_FORMAT, always the first argument of its record.
+// KEY is a field name of LOGGER_THREAD_KV, encoded like STRING and followed by its value.
+enum class LogArgType : std::uint8_t {
+  INT,
+  UINT,
+  DOUBLE,
+  BOOL,
+  CHAR,
+  STRING,
+  LITERAL,
+  FORMAT,
+  KEY
+};
+
+// String with static storage, only its pointer is copied into the log record.
+// The consteval constructor rejects anything that is not a compile-time constant:
+//   LOGGER_THREAD(LogLevel::INFO, LogLiteral("frame done "), frameIndex)
+struct LogLiteral {
+  template <std::size_t N>
+  consteval LogLiteral(const char (&literal)[N]) : text(literal) {}
+
+  const char *text;
+};
+
+// Type a log argument has once decoded by the worker
+template <typename T>
+consteval auto loggerFormatValueType() {
+  using U = std::decay_t<T>;
+  if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+    return std::type_identity<U>();
+  } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    return std::type_identity<std::int64_t>();
+  } else if constexpr (std::is_integral_v<U>) {
+    return std::type_identity<std::uint64_t>();
+  } else if constexpr (std::is_floating_point_v<U>) {
+    return std::type_identity<double>();
+  } else {
+    return std::type_identity<std::string_view>();
+  }
+}
+
+template <typename T>
+using LoggerFormatValue = typename decltype(loggerFormatValueType<T>())::type;
+
+// Pattern of LOGGER_THREAD_FORMAT, checked against the argument types at compile time:
+//   LOGGER_THREAD_FORMAT(LogLevel::INFO, "frame {} took {:.2f} ms", frameIndex, frameTime)
+// With <format> the specs are validated by std::format_string, without it they are parsed
+// but ignored and every value is written in its default form.
+template <typename... Args>
+struct LoggerBasicFormatString {
+  static_assert(sizeof...(Args) <= 32, "LOGGER_THREAD_FORMAT takes at most 32 arguments");
+
+  template <std::size_t N>
+  consteval LoggerBasicFormatString(const char (&pattern)[N]) : text(pattern) {
+    LoggerFormatParser::check(std::string_view(pattern, N - 1), sizeof...(Args));
+#ifdef __cpp_lib_format
+    [[maybe_unused]] std::format_string<LoggerFormatValue<Args>...> checked(pattern);
+#endif
+  }
+
+  const char *text;
+};
+
+template <typename... Args>
+using LoggerFormatString = LoggerBasicFormatString<std::type_identity_t<Args>...>;
+
+template <typename T>
+inline constexpr bool IsLoggerFormatString = false;
+
+template <typename... Args>
+inline constexpr bool IsLoggerFormatString<LoggerBasicFormatString<Args...>> = true;
+
+// Binary encoding of log arguments: one LogArgType byte followed by the raw value.
+// Producers only memcpy values in, text is produced by appendText on the worker.
+class LoggerArgs {
+ public:
+  // Returns the number of bytes written, sets truncated when the value did not fit in room
+  template <typename T>
+  static std::size_t encode(char *out, std::size_t room, const T &value, bool &truncated) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, LogLiteral>) {
+      return encodeValue(out, room, LogArgType::LITERAL, value.text, truncated);
+    } else if constexpr (IsLoggerFormatString<U>) {
+      return encodeValue(out, room, LogArgType::FORMAT, value.text, truncated);
+    } else if constexpr (std::is_same_v<U, bool>) {
+      return encodeValue(out, room, LogArgType::BOOL, value, truncated);
+    } else if constexpr (std::is_same_v<U, char>) {
+      return encodeValue(out, room, LogArgType::CHAR, value, truncated);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+      auto number = static_cast<std::int64_t>(value);
+      return encodeValue(out, room, LogArgType::INT, number, truncated);
+    } else if constexpr (std::is_integral_v<U>) {
+      auto number = static_cast<std::uint64_t>(value);
+      return encodeValue(out, room, LogArgType::UINT, number, truncated);
+    } else if constexpr (std::is_floating_point_v<U>) {
+      auto number = static_cast<double>(value);
+      return encodeValue(out, room, LogArgType::DOUBLE, number, truncated);
+    } else if constexpr (std::is_array_v<T>) {
+      return encodeString(out, room, std::string_view(value), truncated);
+    } else if constexpr (std::is_pointer_v<U> && std::is_convertible_v<U, const char *>) {
+      return encodeString(
+          out, room, value != nullptr ? std::string_view(value) : "(null)", truncated);
+    } else {
+      static_assert(
+          std::is_convertible_v<const T &, std::string_view>, "Unsupported log argument type");
+      return encodeString(out, room, std::string_view(value), truncated);
+    }
+  }
+
+  // Strings are cut to fit the remaining room
+  static std::size_t encodeString(
+      char *out,
+      std::size_t room,
+      std::string_view text,
+      bool &truncated,
+      LogArgType type = LogArgType::STRING) {
+    constexpr std::size_t header = 1 + sizeof(std::uint16_t);
+    if (room <= header) {
+      truncated = true;
+      return 0;
+    }
+    auto size = static_cast<std::uint16_t>(std::min(text.size(), room - header));
+    truncated = truncated || size < text.size();
+    out[0] = static_cast<char>(type);
+    std::memcpy(out + 1, &size, sizeof(size));
+    std::memcpy(out + header, text.data(), size);
+    return header + size;
+  }
+
+  // Reads one raw value and advances it
+  template <typename V>
+  static V read(const char *&it) {
+    V value;
+    std::memcpy(&value, it, sizeof(V));
+    it += sizeof(V);
+    return value;
+  }
+
+  // Decodes every argument of an encoded payload and appends its text to out
+  static void appendText(std::string &out, std::string_view encoded) {
+    const char *it = encoded.data();
+    const char *end = it + encoded.size();
+    while (it < end) {
+      if (static_cast<LogArgType>(*it) == LogArgType::FORMAT) {
+        ++it;
+        const char *pattern = read<const char *>(it);
+        appendFormatted(out, pattern, std::string_view(it, static_cast<std::size_t>(end - it)));
+        return;
+      }
+      if (!appendValue(out, it)) {
+        return;  // Corrupted payload, stop decoding
+      }
+    }
+  }
+
+  // Fills pattern with the encoded arguments following it. Fields whose argument was cut
+  // from a full record are left empty.
+  static void appendFormatted(
+      std::string &out, std::string_view pattern, std::string_view encoded) {
+    const char *values[32];
+    std::size_t count = 0;
+    const char *it = encoded.data();
+    const char *end = it + encoded.size();
+    while (it < end && count < 32) {
+      values[count++] = it;
+      if (!skipValue(it)) {
+        --count;
+        break;
+      }
+    }
+    LoggerFormatParser::forEach(
+        pattern,
+        [&](std::string_view text) { out.append(text); },
+        [&](std::size_t index, std::string_view spec) {
+          if (index >= count) {
+            return;
+          }
+          const char *value = values[index];
+          if (spec.empty()) {
+            appendValue(out, value);
+          } else {
+            appendValueWithSpec(out, value, spec);
+          }
+        });
+  }
+
+ private:
+  // Appends the text of the value at it and moves past it, false for an unknown type
+  static bool appendValue(std::string &out, const char *&it) {
+    char number[32];
+    auto type = static_cast<LogArgType>(*it++);
+    switch (type) {
+      case LogArgType::INT: {
+        auto result = std::to_chars(number, number + sizeof(number), read<std::int64_t>(it));
+        out.append(number, result.ptr);
+        return true;
+      }
+      case LogArgType::UINT: {
+        auto result = std::to_chars(number, number + sizeof(number), read<std::uint64_t>(it));
+        out.append(number, result.ptr);
+        return true;
+      }
+      case LogArgType::DOUBLE: {
+        auto result = std::to_chars(number, number + sizeof(number), read<double>(it));
+        out.append(number, result.ptr);
+        return true;
+      }
+      case LogArgType::BOOL:
+        out.append(read<bool>(it) ? "true" : "false");
+        return true;
+      case LogArgType::CHAR:
+        out.push_back(read<char>(it));
+        return true;
+      case LogArgType::STRING: {
+        auto size = read<std::uint16_t>(it);
+        out.append(it, size);
+        it += size;
+        return true;
+      }
+      case LogArgType::LITERAL:
+        out.append(read<const char *>(it));
+        return true;
+      case LogArgType::KEY: {
+        auto size = read<std::uint16_t>(it);
+        out.push_back(' ');
+        out.append(it, size);
+        out.push_back('=');
+        it += size;
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+ public:
+  // Moves it past one encoded value, false for an unknown type
+  static bool skipValue(const char *&it) {
+    switch (static_cast<LogArgType>(*it++)) {
+      case LogArgType::INT:
+      case LogArgType::UINT:
+      case LogArgType::DOUBLE:
+        it += 8;
+        return true;
+      case LogArgType::BOOL:
+      case LogArgType::CHAR:
+        it += 1;
+        return true;
+      case LogArgType::STRING:
+      case LogArgType::KEY:
+        it += read<std::uint16_t>(it);
+        return true;
+      case LogArgType::LITERAL:
+      case LogArgType::FORMAT:
+        it += sizeof(const char *);
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  // "{:spec}" is run through std::vformat_to for this value only, the buffer is the worker's
+  static void appendValueWithSpec(
+      std::string &out, const char *it, [[maybe_unused]] std::string_view spec) {
+#ifdef __cpp_lib_format
+    char fieldFormat[64];
+    if (spec.size() + 3 > sizeof(fieldFormat)) {
+      appendValue(out, it);
+      return;
+    }
+    fieldFormat[0] = '{';
+    fieldFormat[1] = ':';
+    std::memcpy(fieldFormat + 2, spec.data(), spec.size());
+    fieldFormat[spec.size() + 2] = '}';
+    std::string_view format(fieldFormat, spec.size() + 3);
+    auto append = [&](const auto &value) {
+      std::vformat_to(std::back_inserter(out), format, std::make_format_args(value));
+    };
+    switch (static_cast<LogArgType>(*it++)) {
+      case LogArgType::INT:
+        append(read<std::int64_t>(it));
+        break;
+      case LogArgType::UINT:
+        append(read<std::uint64_t>(it));
+        break;
+      case LogArgType::DOUBLE:
+        append(read<double>(it));
+        break;
+      case LogArgType::BOOL:
+        append(read<bool>(it));
+        break;
+      case LogArgType::CHAR:
+        append(read<char>(it));
+        break;
+      case LogArgType::STRING: {
+        auto size = read<std::uint16_t>(it);
+        append(std::string_view(it, size));
+        break;
+      }
+      case LogArgType::LITERAL:
+        append(std::string_view(read<const char *>(it)));
+        break;
+      default:
+        break;
+    }
+#else
+    appendValue(out, it);
+#endif
+  }
+
+  template <typename V>
+  static std::size_t encodeValue(
+      char *out, std::size_t room, LogArgType type, const V &value, bool &truncated) {
+    if (room < 1 + sizeof(V)) {
+      truncated = true;
+      return 0;
+    }
+    out[0] = static_cast<char>(type);
+    std::memcpy(out + 1, &value, sizeof(V));
+    return 1 + sizeof(V);
+  }
+};
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "LoggerArgs.hpp"
+#include "LoggerClock.hpp"
+#include "LoggerFormatter.hpp"
+#include "LoggerRecord.hpp"
+
+// Compact binary log layout written by LoggerBinarySink and read back by logdecode.
+// Each session starts with the magic and is followed by entries starting with a tag byte:
+//   SITE     id, line, path size, relative path   (once per call site)
+//   LITERAL  id, size, text                       (once per LogLiteral or format string)
+//   RECORD   site id, level byte, timestamp delta, args size, args
+// Integers are LEB128 varints, signed ones and the timestamp delta (nanoseconds since
+// the previous record) are zigzag encoded. Arguments keep their LogArgType byte, with
+// varint integers, string sizes and literal ids in place of the in-memory encoding.
+class LoggerBinaryFormat {
+ public:
+  static constexpr std::string_view Magic{"TLOGBIN1", 8};
+
+  enum class Tag : std::uint8_t { SITE = 1, LITERAL = 2, RECORD = 3 };
+
+  static constexpr std::uint8_t TruncatedFlag = 0x80;  // Set in the level byte
+
+  static void appendVarint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  static void appendSignedVarint(std::string &out, std::int64_t value) {
+    appendVarint(out, (static_cast<std::uint64_t>(value) << 1) ^
+                          static_cast<std::uint64_t>(value >> 63));
+  }
+
+  // Returns false when the input ends in the middle of the number
+  static bool readVarint(const char *&it, const char *end, std::uint64_t &value) {
+    value = 0;
+    for (int shift = 0; it < end && shift < 64; shift += 7) {
+      auto byte = static_cast<std::uint8_t>(*it++);
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool readSignedVarint(const char *&it, const char *end, std::int64_t &value) {
+    std::uint64_t raw;
+    if (!readVarint(it, end, raw)) {
+      return false;
+    }
+    value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+    return true;
+  }
+};
+
+// Worker side writer state: remembers which call sites and literals were already
+// defined in the file so every record only carries ids and argument values.
+class LoggerBinaryEncoder {
+ public:
+  void reset() {
+    sites.clear();
+    fileSites.clear();
+    literals.clear();
+    previousTimestamp = 0;
+  }
+
+  // Appends the record, preceded by the definitions it needs the first time they are seen
+  void append(std::string &out, LoggerFormatter &formatter) {
+    const LogRecord &record = formatter.record();
+    std::uint32_t siteId = siteIdFor(out, formatter);
+
+    args.clear();
+    std::string_view encoded = record.args();
+    const char *it = encoded.data();
+    const char *end = it + encoded.size();
+    while (it < end) {
+      auto type = static_cast<LogArgType>(*it++);
+      args.push_back(static_cast<char>(type));
+      switch (type) {
+        case LogArgType::INT:
+          LoggerBinaryFormat::appendSignedVarint(args, LoggerArgs::read<std::int64_t>(it));
+          break;
+        case LogArgType::UINT:
+          LoggerBinaryFormat::appendVarint(args, LoggerArgs::read<std::uint64_t>(it));
+          break;
+        case LogArgType::DOUBLE:
+          args.append(it, sizeof(double));
+          it += sizeof(double);
+          break;
+        case LogArgType::BOOL:
+        case LogArgType::CHAR:
+          args.push_back(*it++);
+          break;
+        case LogArgType::STRING:
+        case LogArgType::KEY: {
+          auto size = LoggerArgs::read<std::uint16_t>(it);
+          LoggerBinaryFormat::appendVarint(args, size);
+          args.append(it, size);
+          it += size;
+          break;
+        }
+        case LogArgType::LITERAL:
+        case LogArgType::FORMAT:
+          LoggerBinaryFormat::appendVarint(
+              args, literalIdFor(out, LoggerArgs::read<const char *>(it)));
+          break;
+        default:
+          it = end;  // Corrupted payload, keep what was decoded so far
+          args.pop_back();
+          break;
+      }
+    }
+
+    std::int64_t timestamp = formatter.systemNanoseconds();
+    out.push_back(static_cast<char>(LoggerBinaryFormat::Tag::RECORD));
+    LoggerBinaryFormat::appendVarint(out, siteId);
+    auto levelByte = static_cast<std::uint8_t>(record.level);
+    if (record.truncated) {
+      levelByte |= LoggerBinaryFormat::TruncatedFlag;
+    }
+    out.push_back(static_cast<char>(levelByte));
+    LoggerBinaryFormat::appendSignedVarint(out, timestamp - previousTimestamp);
+    LoggerBinaryFormat::appendVarint(out, args.size());
+    out.append(args);
+    previousTimestamp = timestamp;
+  }
+
+ private:
+  std::uint32_t siteIdFor(std::string &out, LoggerFormatter &formatter) {
+    const LogRecord &record = formatter.record();
+    if (record.callSite != nullptr) {
+      auto found = sites.find(record.callSite);
+      if (found != sites.end()) {
+        return found->second;
+      }
+      std::uint32_t id = defineSite(out, formatter.relativePath(), record.line);
+      sites.emplace(record.callSite, id);
+      return id;
+    }
+    // Records logged without a call site are keyed by their path and line
+    std::string_view path = formatter.relativePath();
+    fileSiteKey.assign(path);
+    fileSiteKey.push_back(':');
+    char number[16];
+    auto result = std::to_chars(number, number + sizeof(number), record.line);
+    fileSiteKey.append(number, result.ptr);
+    auto found = fileSites.find(fileSiteKey);
+    if (found != fileSites.end()) {
+      return found->second;
+    }
+    std::uint32_t id = defineSite(out, path, record.line);
+    fileSites.emplace(fileSiteKey, id);
+    return id;
+  }
+
+  std::uint32_t defineSite(std::string &out, std::string_view path, int line) {
+    auto id = static_cast<std::uint32_t>(sites.size() + fileSites.size());
+    out.push_back(static_cast<char>(LoggerBinaryFormat::Tag::SITE));
+    LoggerBinaryFormat::appendVarint(out, id);
+    LoggerBinaryFormat::appendSignedVarint(out, line);
+    LoggerBinaryFormat::appendVarint(out, path.size());
+    out.append(path);
+    return id;
+  }
+
+  std::uint32_t literalIdFor(std::string &out, const char *text) {
+    auto found = literals.find(text);
+    if (found != literals.end()) {
+      return found->second;
+    }
+    auto id = static_cast<std::uint32_t>(literals.size());
+    std::string_view literal(text);
+    out.push_back(static_cast<char>(LoggerBinaryFormat::Tag::LITERAL));
+    LoggerBinaryFormat::appendVarint(out, id);
+    LoggerBinaryFormat::appendVarint(out, literal.size());
+    out.append(literal);
+    literals.emplace(text, id);
+    return id;
+  }
+
+  std::unordered_map<const LoggerCallSite *, std::uint32_t> sites;
+  std::unordered_map<std::string, std::uint32_t> fileSites;
+  std::unordered_map<const char *, std::uint32_t> literals;
+  std::string fileSiteKey;
+  std::string args;
+  std::int64_t previousTimestamp = 0;
+};
+
+// Turns a binary log back into the "[INFO] timestamp [file:line] message" text lines
+class LoggerBinaryDecoder {
+ public:
+  enum class Status { OK, BAD_MAGIC, CORRUPTED };
+
+  // Decodes as many complete entries as data holds and appends their lines to out.
+  // Returns the number of bytes consumed, the rest has to be passed again with more data.
+  std::size_t decode(std::string_view data, std::string &out) {
+    const char *begin = data.data();
+    const char *it = begin;
+    const char *end = begin + data.size();
+    while (it < end && state == Status::OK) {
+      // Every LoggerBinarySink session starts with the magic, appended logs restart ids
+      if (*it == LoggerBinaryFormat::Magic[0] || !headerRead) {
+        std::string_view rest(it, static_cast<std::size_t>(end - it));
+        if (rest.size() < LoggerBinaryFormat::Magic.size()) {
+          break;
+        }
+        if (rest.substr(0, LoggerBinaryFormat::Magic.size()) != LoggerBinaryFormat::Magic) {
+          state = headerRead ? Status::CORRUPTED : Status::BAD_MAGIC;
+          break;
+        }
+        it += LoggerBinaryFormat::Magic.size();
+        sites.clear();
+        literals.clear();
+        previousTimestamp = 0;
+        headerRead = true;
+        continue;
+      }
+      const char *entry = it;
+      std::size_t lineStart = out.size();
+      if (!decodeEntry(it, end, out)) {
+        out.resize(lineStart);
+        it = entry;
+        break;
+      }
+    }
+    return static_cast<std::size_t>(it - begin);
+  }
+
+  Status status() const { return state; }
+
+ private:
+  struct Site {
+    std::string path;
+    int line = 0;
+  };
+
+  // False when the entry is incomplete or corrupted, status tells the two apart
+  bool decodeEntry(const char *&it, const char *end, std::string &out) {
+    auto tag = static_cast<LoggerBinaryFormat::Tag>(*it++);
+    std::uint64_t id;
+    if (!LoggerBinaryFormat::readVarint(it, end, id)) {
+      return false;
+    }
+    switch (tag) {
+      case LoggerBinaryFormat::Tag::SITE: {
+        std::int64_t line;
+        std::string_view path;
+        if (!LoggerBinaryFormat::readSignedVarint(it, end, line) || !readBytes(it, end, path)) {
+          return false;
+        }
+        if (id >= sites.size()) {
+          sites.resize(id + 1);
+        }
+        sites[id].path.assign(path);
+        sites[id].line = static_cast<int>(line);
+        return true;
+      }
+      case LoggerBinaryFormat::Tag::LITERAL: {
+        std::string_view text;
+        if (!readBytes(it, end, text)) {
+          return false;
+        }
+        if (id >= literals.size()) {
+          literals.resize(id + 1);
+        }
+        literals[id].assign(text);
+        return true;
+      }
+      case LoggerBinaryFormat::Tag::RECORD:
+        return decodeRecord(it, end, id, out);
+    }
+    state = Status::CORRUPTED;
+    return false;
+  }
+
+  bool decodeRecord(const char *&it, const char *end, std::uint64_t siteId, std::string &out) {
+    if (it >= end) {
+      return false;
+    }
+    auto levelByte = static_cast<std::uint8_t>(*it++);
+    std::int64_t delta;
+    std::string_view encoded;
+    if (!LoggerBinaryFormat::readSignedVarint(it, end, delta) || !readBytes(it, end, encoded)) {
+      return false;
+    }
+    if (siteId >= sites.size()) {
+      state = Status::CORRUPTED;
+      return false;
+    }
+    previousTimestamp += delta;
+    const Site &site = sites[siteId];
+    auto level = static_cast<LogLevel>(levelByte & ~LoggerBinaryFormat::TruncatedFlag);
+
+    out.append(LoggerFormatter::levelTag(level));
+    out.append(timestamps.format(previousTimestamp));
+    out.append(" [");
+    out.append(site.path);
+    out.push_back(':');
+    char number[32];
+    auto result = std::to_chars(number, number + sizeof(number), site.line);
+    out.append(number, result.ptr);
+    out.append("] ");
+    if (!appendArgs(encoded, out)) {
+      state = Status::CORRUPTED;
+      return false;
+    }
+    if ((levelByte & LoggerBinaryFormat::TruncatedFlag) != 0) {
+      out.append("...");
+    }
+    out.push_back('\n');
+    return true;
+  }
+
+  // Arguments are converted back to the in-memory encoding so LoggerArgs formats them,
+  // literal and format pointers point into the literal table
+  bool appendArgs(std::string_view encoded, std::string &out) {
+    const char *it = encoded.data();
+    const char *end = it + encoded.size();
+    native.clear();
+    while (it < end) {
+      auto type = static_cast<LogArgType>(*it++);
+      native.push_back(static_cast<char>(type));
+      switch (type) {
+        case LogArgType::INT: {
+          std::int64_t value;
+          if (!LoggerBinaryFormat::readSignedVarint(it, end, value)) {
+            return false;
+          }
+          native.append(reinterpret_cast<const char *>(&value), sizeof(value));
+          break;
+        }
+        case LogArgType::UINT: {
+          std::uint64_t value;
+          if (!LoggerBinaryFormat::readVarint(it, end, value)) {
+            return false;
+          }
+          native.append(reinterpret_cast<const char *>(&value), sizeof(value));
+          break;
+        }
+        case LogArgType::DOUBLE:
+        case LogArgType::BOOL:
+        case LogArgType::CHAR: {
+          std::size_t valueSize = type == LogArgType::DOUBLE ? sizeof(double) : 1;
+          if (static_cast<std::size_t>(end - it) < valueSize) {
+            return false;
+          }
+          native.append(it, valueSize);
+          it += valueSize;
+          break;
+        }
+        case LogArgType::STRING:
+        case LogArgType::KEY: {
+          std::string_view text;
+          if (!readBytes(it, end, text) || text.size() > UINT16_MAX) {
+            return false;
+          }
+          auto size = static_cast<std::uint16_t>(text.size());
+          native.append(reinterpret_cast<const char *>(&size), sizeof(size));
+          native.append(text);
+          break;
+        }
+        case LogArgType::LITERAL:
+        case LogArgType::FORMAT: {
+          std::uint64_t id;
+          if (!LoggerBinaryFormat::readVarint(it, end, id) || id >= literals.size()) {
+            return false;
+          }
+          const char *text = literals[id].c_str();
+          native.append(reinterpret_cast<const char *>(&text), sizeof(text));
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    LoggerArgs::appendText(out, native);
+    return true;
+  }
+
+  static bool readBytes(const char *&it, const char *end, std::string_view &bytes) {
+    std::uint64_t size;
+    if (!LoggerBinaryFormat::readVarint(it, end, size) ||
+        size > static_cast<std::uint64_t>(end - it)) {
+      return false;
+    }
+    bytes = std::string_view(it, size);
+    it += size;
+    return true;
+  }
+
+  bool headerRead = false;
+  Status state = Status::OK;
+  std::vector<Site> sites;
+  std::vector<std::string> literals;
+  std::string native;
+  std::int64_t previousTimestamp = 0;
+  LoggerTimestamp timestamps;
+};
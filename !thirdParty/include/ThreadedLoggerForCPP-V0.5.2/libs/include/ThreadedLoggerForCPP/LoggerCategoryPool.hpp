@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LoggerThread.h"
+
+/*
+Named log categories spread over a small pool of workers. Every worker is a LoggerThread
+with its own queue and its own sinks, so a category stuck behind a slow sink only holds
+up the categories sharing its worker. Records of one category always go through the same
+queue and keep their order.
+Usage example:
+  static LoggerCategoryPool categories(2);
+  static const LoggerCategory &renderLog =
+      categories.AddCategory("render", std::make_unique<LoggerFileSink>("render.log", true));
+  LOGGER_THREAD_CATEGORY(renderLog, LogLevel::INFO, "frame ", frameIndex)
+*/
+class LoggerCategoryPool {
+ public:
+  explicit LoggerCategoryPool(
+      std::size_t workerCount = 2, std::size_t queueCapacity = LoggerThread::DefaultQueueCapacity)
+      : categoriesPerWorker(std::max<std::size_t>(workerCount, 1), 0) {
+    for (std::size_t i = 0; i < categoriesPerWorker.size(); ++i) {
+      workers.push_back(std::make_unique<LoggerThread>(LoggerClockSource::SYSTEM, queueCapacity));
+      workers.back()->ClearSinks();  // Only category sinks, no default console
+    }
+  }
+
+  LoggerCategoryPool(const LoggerCategoryPool &) = delete;
+  LoggerCategoryPool &operator=(const LoggerCategoryPool &) = delete;
+
+  // worker < 0 picks the worker with the fewest categories. A category writing to a slow
+  // output (network share, huge dumps) should get a worker of its own.
+  // Adding a name a second time returns the existing category with sink added to it.
+  const LoggerCategory &AddCategory(
+      const std::string &name, std::unique_ptr<LoggerSink> sink, int worker = -1) {
+    std::unique_lock<std::mutex> lock(mtx);
+    LoggerCategory *category = find(name);
+    if (category == nullptr) {
+      std::size_t index = worker >= 0 && static_cast<std::size_t>(worker) < workers.size()
+                              ? static_cast<std::size_t>(worker)
+                              : leastLoadedWorker();
+      ++categoriesPerWorker[index];
+      auto id = static_cast<std::uint16_t>(categories.size() + 1);
+      category = &categories.emplace_back(LoggerCategory{name, id, workers[index].get()});
+    }
+    if (sink != nullptr) {
+      sink->setCategory(category->id);
+      category->logger->AddSink(std::move(sink));
+    }
+    return *category;
+  }
+
+  // nullptr when no category has this name
+  const LoggerCategory *FindCategory(std::string_view name) {
+    std::unique_lock<std::mutex> lock(mtx);
+    return find(name);
+  }
+
+  std::size_t WorkerCount() const { return workers.size(); }
+
+  // For settings shared by the categories of a worker: level, flush policy, queue mode...
+  LoggerThread &Worker(std::size_t index) { return *workers.at(index); }
+
+ private:
+  std::size_t leastLoadedWorker() const {
+    auto least = std::min_element(categoriesPerWorker.begin(), categoriesPerWorker.end());
+    return static_cast<std::size_t>(least - categoriesPerWorker.begin());
+  }
+
+  LoggerCategory *find(std::string_view name) {
+    for (auto &category : categories) {
+      if (category.name == name) {
+        return &category;
+      }
+    }
+    return nullptr;
+  }
+
+  std::mutex mtx;
+  std::vector<std::unique_ptr<LoggerThread>> workers;
+  std::vector<std::size_t> categoriesPerWorker;  // Guarded by mtx
+  std::deque<LoggerCategory> categories;          // Guarded by mtx, references stay valid
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+enum class LoggerClockSource { SYSTEM, MONOTONIC_COARSE, TSC };
+
+// Timestamp capture used on the producer side. now() returns raw ticks of the chosen
+// source, toSystemNanoseconds converts them back to wall clock time on the worker.
+class LoggerClock {
+ public:
+  explicit LoggerClock(LoggerClockSource clockSource = LoggerClockSource::SYSTEM)
+      : source(clockSource) {
+#if !defined(_MSC_VER) && !defined(__x86_64__) && !defined(__i386__)
+    if (source == LoggerClockSource::TSC) {
+      source = LoggerClockSource::MONOTONIC_COARSE;
+    }
+#endif
+    calibrate();
+  }
+
+  std::uint64_t now() const {
+    switch (source) {
+      case LoggerClockSource::MONOTONIC_COARSE:
+        return monotonicNanoseconds();
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+      case LoggerClockSource::TSC:
+        return __rdtsc();
+#endif
+      default:
+        return static_cast<std::uint64_t>(systemNanoseconds());
+    }
+  }
+
+  std::int64_t toSystemNanoseconds(std::uint64_t ticks) const {
+    if (source == LoggerClockSource::SYSTEM) {
+      return static_cast<std::int64_t>(ticks);
+    }
+    auto elapsed = static_cast<double>(static_cast<std::int64_t>(ticks - baseTicks));
+    return baseSystemNanoseconds + static_cast<std::int64_t>(elapsed / ticksPerNanosecond);
+  }
+
+  LoggerClockSource clockSource() const { return source; }
+
+ private:
+  static std::int64_t systemNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static std::uint64_t monotonicNanoseconds() {
+#ifdef __linux__
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+#endif
+  }
+
+  // Pairs a tick reading with the wall clock, TSC also measures its frequency over ~10ms
+  void calibrate() {
+    baseTicks = now();
+    baseSystemNanoseconds = systemNanoseconds();
+    ticksPerNanosecond = 1.0;
+    if (source == LoggerClockSource::TSC) {
+      auto start = std::chrono::steady_clock::now();
+      while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10)) {
+      }
+      auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start);
+      ticksPerNanosecond =
+          static_cast<double>(now() - baseTicks) / static_cast<double>(elapsed.count());
+    }
+  }
+
+  LoggerClockSource source;
+  std::uint64_t baseTicks = 0;
+  std::int64_t baseSystemNanoseconds = 0;
+  double ticksPerNanosecond = 1.0;
+};
+
+// Worker side timestamp text. The "%Y-%m-%d-%H-%M-%S" prefix is only rebuilt when the
+// second changes, every message just writes its milliseconds after it.
+class LoggerTimestamp {
+ public:
+  std::string_view format(std::int64_t systemNanoseconds) {
+    std::int64_t seconds = systemNanoseconds / 1000000000;
+    std::int64_t nanoseconds = systemNanoseconds % 1000000000;
+    if (nanoseconds < 0) {
+      seconds -= 1;
+      nanoseconds += 1000000000;
+    }
+    if (seconds != cachedSecond) {
+      auto in_time_t = static_cast<std::time_t>(seconds);
+      struct tm timeinfo;
+#ifdef _WIN32
+      localtime_s(&timeinfo, &in_time_t);
+#else
+      localtime_r(&in_time_t, &timeinfo);
+#endif
+      prefixSize = strftime(buffer, sizeof(buffer) - 4, "%Y-%m-%d-%H-%M-%S", &timeinfo);
+      cachedSecond = seconds;
+    }
+    auto millis = static_cast<int>(nanoseconds / 1000000);
+    buffer[prefixSize] = '.';
+    buffer[prefixSize + 1] = static_cast<char>('0' + millis / 100);
+    buffer[prefixSize + 2] = static_cast<char>('0' + millis / 10 % 10);
+    buffer[prefixSize + 3] = static_cast<char>('0' + millis % 10);
+    return std::string_view(buffer, prefixSize + 4);
+  }
+
+ private:
+  std::int64_t cachedSecond = INT64_MIN;
+  std::size_t prefixSize = 0;
+  char buffer[64];
+};
@@ -3,9 +3,17 @@
 #include <ThreadedLoggerForCPP/LoggerThread.h>
 #include <sys/stat.h>
 
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <pwd.h>
+#include <unistd.h>
+#endif
 
 
 class LoggerFileSystem {
@@ -44,16 +52,78 @@ class LoggerFileSystem {
       return false;
   }
 
+  // Creates path and its missing parents without going through a shell
   static bool createDirectories(const std::string &path) {
-    if (!directoryExists(path)) {
-      std::string command = "mkdir " + path;
-      if (system(command.c_str()) != 0) {
-        std::cerr << "Error: Unable to create directory " << path << ".\n";
-        return false;
-      }
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error) {
+      std::cerr << "Error: Unable to create directory " << path << ": " << error.message()
+                << ".\n";
+      return false;
     }
     return true;
   }
+
+  // Per-user folder for the logs of appName, from the environment only:
+  // Windows   %USERPROFILE%\.appName\logging
+  // macOS     $HOME/Library/Logs/appName
+  // Others    $XDG_STATE_HOME/appName/logging, by default ~/.local/state/appName/logging
+  // Falls back to appName/logging in the working directory when no home can be found.
+  static std::filesystem::path defaultLogFolder(const std::string &appName) {
+#ifdef _WIN32
+    std::filesystem::path profile = environmentPath("USERPROFILE");
+    if (!profile.empty()) {
+      return profile / ("." + appName) / "logging";
+    }
+#else
+    std::filesystem::path home = homeFolder();
+#ifdef __APPLE__
+    if (!home.empty()) {
+      return home / "Library" / "Logs" / appName;
+    }
+#else
+    std::filesystem::path state = environmentPath("XDG_STATE_HOME");
+    if (state.is_absolute()) {
+      return state / appName / "logging";
+    }
+    if (!home.empty()) {
+      return home / ".local" / "state" / appName / "logging";
+    }
+#endif
+#endif
+    return std::filesystem::path(appName) / "logging";
+  }
+
+ private:
+  // Empty when the variable is not set, never a null pointer
+  static std::filesystem::path environmentPath(const char *name) {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4996)  // getenv is only read, never kept
+#endif
+    const char *value = std::getenv(name);
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    return value != nullptr ? std::filesystem::path(value) : std::filesystem::path();
+  }
+
+#ifndef _WIN32
+  static std::filesystem::path homeFolder() {
+    std::filesystem::path home = environmentPath("HOME");
+    if (!home.empty()) {
+      return home;
+    }
+    struct passwd entry;
+    struct passwd *result = nullptr;
+    char buffer[4096];
+    if (getpwuid_r(getuid(), &entry, buffer, sizeof(buffer), &result) == 0 && result != nullptr &&
+        result->pw_dir != nullptr) {
+      return result->pw_dir;
+    }
+    return {};
+  }
+#endif
 #else
  public:
   static bool fileExists(const std::string &filename) { return false; }
@@ -63,6 +133,10 @@ class LoggerFileSystem {
   static bool directoryExists(const std::string &path) { return false; }
 
   static bool createDirectories(const std::string &path) { return false; }
+
+  static std::filesystem::path defaultLogFolder(const std::string &appName) {
+    return std::filesystem::path(appName) / "logging";
+  }
 #endif
 #endif
 #endif
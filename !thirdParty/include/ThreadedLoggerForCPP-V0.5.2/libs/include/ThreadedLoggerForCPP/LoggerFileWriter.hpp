@@ -0,0 +1,162 @@
+#pragma once
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "LoggerRecord.hpp"
+
+// When the worker hands buffered lines to the operating system
+struct LoggerFlushPolicy {
+  std::size_t maxBufferedBytes = 64 * 1024;    // Flush once this much text is waiting
+  std::chrono::milliseconds maxInterval{100};  // Flush text older than this
+  LogLevel flushLevel = LogLevel::ERRORING;    // Flush at once for this level and above
+  bool flushWhenIdle = true;                   // Flush as soon as the queue runs dry
+};
+
+// Appends formatted lines to a buffer and writes the whole batch with a single
+// write call, replacing the two std::endl flushes per message.
+class LoggerFileWriter {
+ public:
+  LoggerFileWriter() { buffer.reserve(policy.maxBufferedBytes + 1024); }
+
+  ~LoggerFileWriter() { close(); }
+
+  LoggerFileWriter(const LoggerFileWriter &) = delete;
+  LoggerFileWriter &operator=(const LoggerFileWriter &) = delete;
+
+  bool open(const std::string &path, bool truncate) {
+    close();
+    // Appending keeps lines whole when another process writes the same file, and the
+    // descriptor is not inherited by child processes
+#ifdef _WIN32
+    int flags = _O_WRONLY | _O_CREAT | _O_BINARY | _O_APPEND | _O_NOINHERIT;
+    fd = _open(path.c_str(), flags | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+    fd = ::open(path.c_str(), flags | (truncate ? O_TRUNC : 0), 0644);
+#endif
+    ownsFd = fd >= 0;
+    fileBytes = 0;
+    if (ownsFd && !truncate) {
+#ifdef _WIN32
+      fileBytes = static_cast<std::uint64_t>(std::max<__int64>(_lseeki64(fd, 0, SEEK_END), 0));
+#else
+      fileBytes = static_cast<std::uint64_t>(std::max<off_t>(::lseek(fd, 0, SEEK_END), 0));
+#endif
+    }
+    return ownsFd;
+  }
+
+  // Writes to an already open descriptor such as stdout, which is never closed
+  void attach(int descriptor) {
+    close();
+    fd = descriptor;
+    ownsFd = false;
+  }
+
+  void close() {
+    flush();
+    if (ownsFd) {
+#ifdef _WIN32
+      _close(fd);
+#else
+      ::close(fd);
+#endif
+    }
+    fd = -1;
+    ownsFd = false;
+  }
+
+  bool isOpen() const { return fd >= 0; }
+
+  int descriptor() const { return fd; }
+
+  // Bytes in the file plus the ones still buffered
+  std::uint64_t size() const { return fileBytes + buffer.size(); }
+
+  void setPolicy(const LoggerFlushPolicy &flushPolicy) {
+    policy = flushPolicy;
+    buffer.reserve(policy.maxBufferedBytes + 1024);
+  }
+
+  // Buffers one line, flushing when the byte or level policy asks for it
+  void writeLine(std::string_view line, LogLevel level) {
+    markPending();
+    buffer.append(line);
+    buffer.push_back('\n');
+    applyPolicy(level);
+  }
+
+  // Same as writeLine for binary data, nothing is appended
+  void write(std::string_view data, LogLevel level) {
+    markPending();
+    buffer.append(data);
+    applyPolicy(level);
+  }
+
+  // Called by the worker between batches, handles the idle and interval policies
+  void flushIfDue(bool queueEmpty) {
+    if (buffer.empty()) {
+      return;
+    }
+    if ((queueEmpty && policy.flushWhenIdle) ||
+        std::chrono::steady_clock::now() - oldestPending >= policy.maxInterval) {
+      flush();
+    }
+  }
+
+  void flush() {
+    const char *data = buffer.data();
+    std::size_t remaining = buffer.size();
+    while (remaining > 0 && fd >= 0) {
+#ifdef _WIN32
+      int written = _write(fd, data, static_cast<unsigned int>(remaining));
+#else
+      ssize_t written = ::write(fd, data, remaining);
+#endif
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break;  // Nothing sensible to report to, drop the batch
+      }
+      data += written;
+      remaining -= static_cast<std::size_t>(written);
+      fileBytes += static_cast<std::uint64_t>(written);
+    }
+    buffer.clear();
+  }
+
+ private:
+  void markPending() {
+    if (buffer.empty()) {
+      oldestPending = std::chrono::steady_clock::now();
+    }
+  }
+
+  void applyPolicy(LogLevel level) {
+    if (buffer.size() >= policy.maxBufferedBytes || level >= policy.flushLevel) {
+      flush();
+    }
+  }
+
+  int fd = -1;
+  bool ownsFd = false;
+  std::uint64_t fileBytes = 0;
+  LoggerFlushPolicy policy;
+  std::string buffer;
+  std::chrono::steady_clock::time_point oldestPending;
+};
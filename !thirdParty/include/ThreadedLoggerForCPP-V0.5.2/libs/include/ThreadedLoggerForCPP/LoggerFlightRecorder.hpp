@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "LoggerRingBuffer.hpp"
+#include "LoggerSink.hpp"
+
+// Keeps the last formatted lines in a ring allocated up front and writes nothing while the
+// game runs normally. The ring goes to the dump file when a record reaches dumpLevel, when
+// LoggerThread::DumpFlightRecorder is called, or from the SIGSEGV/SIGABRT handler.
+class LoggerFlightRecorderSink : public LoggerSink {
+ public:
+  static constexpr std::size_t SlotSize = 512;  // Longer lines are cut
+
+  LoggerFlightRecorderSink(
+      const std::string &dumpPath,
+      std::size_t capacity,
+      LogLevel dumpAtLevel = LogLevel::ERRORING,
+      LogLevel level = LogLevel::INFO)
+      : LoggerSink(level),
+        mask(LoggerRingBuffer::roundUpToPowerOfTwo(capacity) - 1),
+        slots(new Slot[mask + 1]),
+        dumpLevel(dumpAtLevel) {
+    writer.open(dumpPath, false);
+  }
+
+  ~LoggerFlightRecorderSink() override {
+    LoggerFlightRecorderSink *self = this;
+    crashRecorder.compare_exchange_strong(self, nullptr);
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+
+  void write(LoggerFormatter &formatter) override {
+    std::uint64_t index = written.load(std::memory_order_relaxed);
+    Slot &slot = slots[index & mask];
+    std::string_view text = formatter.text();
+    std::size_t size = std::min(text.size(), SlotSize - sizeof(slot.size) - 1);
+    std::memcpy(slot.text, text.data(), size);
+    slot.text[size] = '\n';
+    slot.size = static_cast<std::uint16_t>(size + 1);
+    written.store(index + 1, std::memory_order_release);
+    if (formatter.record().level >= dumpLevel) {
+      dump();
+    }
+  }
+
+  // Writes the lines recorded since the previous dump, worker thread only
+  void dump() override {
+    std::uint64_t end = written.load(std::memory_order_relaxed);
+    std::uint64_t begin = firstUndumped(end, 0);
+    if (begin == end) {
+      return;
+    }
+    writer.write("---- flight recorder dump ----\n", LogLevel::INFO);
+    for (std::uint64_t i = begin; i < end; ++i) {
+      const Slot &slot = slots[i & mask];
+      writer.write(std::string_view(slot.text, slot.size), LogLevel::INFO);
+    }
+    writer.flush();
+    dumped.store(end, std::memory_order_relaxed);
+  }
+
+  // Dumps this recorder when the process gets SIGSEGV or SIGABRT, then lets the signal go on
+  // to the handler installed before. Only one recorder can be installed at a time.
+  void installCrashHandler() {
+    crashRecorder.store(this);
+    if (!handlersInstalled.exchange(true)) {
+      previousSegvHandler = std::signal(SIGSEGV, &LoggerFlightRecorderSink::onCrash);
+      previousAbortHandler = std::signal(SIGABRT, &LoggerFlightRecorderSink::onCrash);
+    }
+  }
+
+ private:
+  struct Slot {
+    std::uint16_t size = 0;
+    char text[SlotSize - sizeof(std::uint16_t)];
+  };
+
+  // keep is the number of slots to leave out at the oldest end of a full ring
+  std::uint64_t firstUndumped(std::uint64_t end, std::uint64_t keep) const {
+    std::uint64_t begin = dumped.load(std::memory_order_relaxed);
+    std::uint64_t available = mask + 1 - keep;
+    std::uint64_t oldest = end > available ? end - available : 0;
+    return std::max(begin, oldest);
+  }
+
+  // Async-signal-safe: no allocation, no locks, only write calls on an already open file.
+  // The record the worker was copying when the signal hit may come out cut.
+  void dumpFromSignal() const {
+    int fd = writer.descriptor();
+    if (fd < 0) {
+      return;
+    }
+    std::uint64_t end = written.load(std::memory_order_acquire);
+    static constexpr char header[] = "---- flight recorder dump (crash) ----\n";
+    writeAll(fd, header, sizeof(header) - 1);
+    // The slot after the newest one is the next the worker overwrites, skip it
+    for (std::uint64_t i = firstUndumped(end, 1); i < end; ++i) {
+      const Slot &slot = slots[i & mask];
+      writeAll(fd, slot.text, std::min<std::size_t>(slot.size, sizeof(slot.text)));
+    }
+  }
+
+  static void writeAll(int fd, const char *data, std::size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+      int result = _write(fd, data, static_cast<unsigned int>(size));
+#else
+      ssize_t result = ::write(fd, data, size);
+#endif
+      if (result <= 0) {
+        return;
+      }
+      data += result;
+      size -= static_cast<std::size_t>(result);
+    }
+  }
+
+  static void onCrash(int signal) {
+    LoggerFlightRecorderSink *recorder = crashRecorder.exchange(nullptr);
+    if (recorder != nullptr) {
+      recorder->dumpFromSignal();
+    }
+    auto previous = signal == SIGSEGV ? previousSegvHandler : previousAbortHandler;
+    std::signal(signal, previous == SIG_ERR ? SIG_DFL : previous);
+    std::raise(signal);
+  }
+
+  const std::uint64_t mask;
+  std::unique_ptr<Slot[]> slots;
+  const LogLevel dumpLevel;
+  std::atomic<std::uint64_t> written{0};
+  std::atomic<std::uint64_t> dumped{0};
+  LoggerFileWriter writer;
+
+  static inline std::atomic<LoggerFlightRecorderSink *> crashRecorder{nullptr};
+  static inline std::atomic<bool> handlersInstalled{false};
+  static inline void (*previousSegvHandler)(int) = SIG_DFL;
+  static inline void (*previousAbortHandler)(int) = SIG_DFL;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Replacement fields of LOGGER_THREAD_FORMAT patterns, the std::format subset the worker
+// supports: "{}", "{0}", "{:spec}", "{0:spec}", "{{" and "}}". Nested fields such as
+// "{:{}}" are rejected. Used at compile time by LoggerFormatString and by the worker.
+class LoggerFormatParser {
+ public:
+  // Calls text(std::string_view) for literal runs and field(argIndex, spec) for every
+  // replacement field. Returns false on a malformed pattern.
+  template <typename Text, typename Field>
+  static constexpr bool forEach(std::string_view pattern, Text &&text, Field &&field) {
+    std::size_t nextArg = 0;
+    bool automatic = false;
+    bool manual = false;
+    std::size_t start = 0;
+    std::size_t i = 0;
+    while (i < pattern.size()) {
+      char c = pattern[i];
+      if (c != '{' && c != '}') {
+        ++i;
+        continue;
+      }
+      if (i + 1 < pattern.size() && pattern[i + 1] == c) {
+        text(pattern.substr(start, i + 1 - start));
+        i += 2;
+        start = i;
+        continue;
+      }
+      if (c == '}') {
+        return false;
+      }
+      text(pattern.substr(start, i - start));
+      std::size_t close = pattern.find('}', i + 1);
+      if (close == std::string_view::npos) {
+        return false;
+      }
+      std::string_view inside = pattern.substr(i + 1, close - i - 1);
+      if (inside.find('{') != std::string_view::npos) {
+        return false;
+      }
+      std::size_t colon = inside.find(':');
+      std::string_view id = inside.substr(0, colon);
+      std::string_view spec =
+          colon == std::string_view::npos ? std::string_view() : inside.substr(colon + 1);
+      std::size_t index = 0;
+      if (id.empty()) {
+        automatic = true;
+        index = nextArg++;
+      } else {
+        manual = true;
+        for (char digit : id) {
+          if (digit < '0' || digit > '9') {
+            return false;
+          }
+          index = index * 10 + static_cast<std::size_t>(digit - '0');
+        }
+      }
+      if (automatic && manual) {
+        return false;  // Same rule as std::format
+      }
+      field(index, spec);
+      i = close + 1;
+      start = i;
+    }
+    text(pattern.substr(start));
+    return true;
+  }
+
+  // Compile time check, a throw in a consteval call is reported as a compiler error
+  static constexpr void check(std::string_view pattern, std::size_t argCount) {
+    bool inRange = true;
+    bool valid = forEach(
+        pattern,
+        [](std::string_view) {},
+        [&](std::size_t index, std::string_view) { inRange = inRange && index < argCount; });
+    if (!valid) {
+      throw "LOGGER_THREAD_FORMAT: malformed format string";
+    }
+    if (!inRange) {
+      throw "LOGGER_THREAD_FORMAT: format string uses more arguments than given";
+    }
+  }
+};
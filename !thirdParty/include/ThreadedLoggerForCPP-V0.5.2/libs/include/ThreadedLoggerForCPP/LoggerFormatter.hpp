@@ -0,0 +1,119 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+#include "LoggerClock.hpp"
+#include "LoggerGlobals.hpp"
+#include "LoggerRecord.hpp"
+
+// Worker side text formatting shared by the sinks. The standard line is built at most
+// once per record no matter how many sinks ask for it.
+class LoggerFormatter {
+ public:
+  explicit LoggerFormatter(const LoggerClock &loggerClock) : clock(loggerClock) {}
+
+  void reset(const LogRecord &record) {
+    current = &record;
+    lineReady = false;
+    messageReady = false;
+  }
+
+  const LogRecord &record() const { return *current; }
+
+  // "[INFO] timestamp [file:line] message"
+  std::string_view text() {
+    if (!lineReady) {
+      line.clear();
+      line.append(levelTag(current->level));
+      line.append(timestamp());
+      line.append(" [");
+      line.append(relativePath());
+      line.push_back(':');
+      char number[16];
+      auto result = std::to_chars(number, number + sizeof(number), current->line);
+      line.append(number, result.ptr);
+      line.append("] ");
+      line.append(message());
+      lineReady = true;
+    }
+    return line;
+  }
+
+  // Decoded arguments only
+  std::string_view message() {
+    if (!messageReady) {
+      messageText.clear();
+      current->appendMessage(messageText);
+      messageReady = true;
+    }
+    return messageText;
+  }
+
+  std::string_view relativePath() const {
+    if (current->callSite != nullptr) {
+      return callSiteRelativePath(*current->callSite);
+    }
+    return extractRelativePath(current->file());
+  }
+
+  std::string_view timestamp() {
+    return timestamps.format(clock.toSystemNanoseconds(current->timestamp));
+  }
+
+  std::int64_t systemNanoseconds() const { return clock.toSystemNanoseconds(current->timestamp); }
+
+  // For tick values carried as arguments, such as the start of a span
+  std::int64_t systemNanoseconds(std::uint64_t ticks) const {
+    return clock.toSystemNanoseconds(ticks);
+  }
+
+  static std::string_view levelTag(LogLevel level) {
+    switch (level) {
+      case LogLevel::INFO:
+        return "[INFO] ";
+      case LogLevel::WARNING:
+        return "[WARNING] ";
+      case LogLevel::ERRORING:
+        return "[ERROR] ";
+      case LogLevel::LOGICERROR:
+        return "[LOGIC ERROR] ";
+    }
+    return "";
+  }
+
+  // Cached in the call site, extractRelativePath only runs once per LOGGER_THREAD line
+  static std::string_view callSiteRelativePath(const LoggerCallSite &site) {
+    int offset = site.relativeOffset.load(std::memory_order_relaxed);
+    if (offset < 0) {
+      std::string_view file(site.file, site.fileSize);
+      size_t srcIndex = file.rfind(LoggerGlobals::SrcProjectDirectory, site.fileNameOffset);
+      std::size_t start = srcIndex != std::string_view::npos ? srcIndex : site.fileNameOffset;
+      offset = static_cast<int>(start);
+      site.relativeOffset.store(offset, std::memory_order_relaxed);
+    }
+    return std::string_view(site.file + offset, site.fileSize - offset);
+  }
+
+  static std::string_view extractRelativePath(std::string_view filePath) {
+    size_t found = filePath.find_last_of("/\\");
+    if (found != std::string_view::npos) {
+      size_t srcIndex = filePath.rfind(LoggerGlobals::SrcProjectDirectory, found);
+      if (srcIndex != std::string_view::npos) {
+        return filePath.substr(srcIndex);
+      }
+      return filePath.substr(found);
+    }
+    return filePath;
+  }
+
+ private:
+  const LoggerClock &clock;
+  const LogRecord *current = nullptr;
+  LoggerTimestamp timestamps;
+  bool lineReady = false;
+  bool messageReady = false;
+  std::string line;
+  std::string messageText;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "LoggerRecord.hpp"
+
+inline constexpr std::size_t LoggerLevelCount = 4;
+
+struct LoggerLatencySummary {
+  std::uint64_t count = 0;
+  std::uint64_t p50 = 0;  // Nanoseconds, upper bound of the bucket holding the percentile
+  std::uint64_t p99 = 0;
+  std::uint64_t p999 = 0;
+  std::uint64_t max = 0;
+};
+
+// HDR style histogram of nanosecond values: 16 linear sub-buckets per power of two keep the
+// relative error under 7% from 1 ns to the full 64-bit range in a fixed 8 KB table.
+// record is meant for a single writer (the worker), summary can run on any thread.
+class LoggerLatencyHistogram {
+ public:
+  static constexpr unsigned SubBucketBits = 4;
+  static constexpr std::uint64_t SubBucketCount = 1 << SubBucketBits;
+  static constexpr std::size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+  void record(std::uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (value > max.load(std::memory_order_relaxed)) {
+      max.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  LoggerLatencySummary summary() const {
+    LoggerLatencySummary result;
+    result.count = count.load(std::memory_order_relaxed);
+    result.max = max.load(std::memory_order_relaxed);
+    if (result.count == 0) {
+      return result;
+    }
+    const std::uint64_t targets[] = {
+        (result.count * 500 + 999) / 1000, (result.count * 990 + 999) / 1000,
+        (result.count * 999 + 999) / 1000};
+    std::uint64_t *values[] = {&result.p50, &result.p99, &result.p999};
+    std::uint64_t seen = 0;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < BucketCount && next < 3; ++i) {
+      seen += buckets[i].load(std::memory_order_relaxed);
+      while (next < 3 && seen >= targets[next]) {
+        *values[next++] = std::min(bucketUpperBound(i), result.max);
+      }
+    }
+    return result;
+  }
+
+  // Adds the values recorded by other, neither histogram may be written meanwhile
+  void merge(const LoggerLatencyHistogram &other) {
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+      buckets[i].fetch_add(
+          other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    count.fetch_add(other.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    max.store(
+        std::max(max.load(std::memory_order_relaxed), other.max.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+  }
+
+  static std::size_t bucketIndex(std::uint64_t value) {
+    if (value < SubBucketCount) {
+      return static_cast<std::size_t>(value);
+    }
+    unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+    unsigned shift = exponent - SubBucketBits;
+    std::uint64_t subBucket = (value >> shift) & (SubBucketCount - 1);
+    return static_cast<std::size_t>((shift + 1) * SubBucketCount + subBucket);
+  }
+
+  static std::uint64_t bucketUpperBound(std::size_t index) {
+    if (index < SubBucketCount) {
+      return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+    std::uint64_t subBucket = index % SubBucketCount;
+    std::uint64_t lower = (SubBucketCount + subBucket) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, BucketCount> buckets{};
+  std::atomic<std::uint64_t> count{0};
+  std::atomic<std::uint64_t> max{0};
+};
+
+// Copy of the logger counters returned by LoggerThread::GetMetrics
+struct LoggerMetricsSnapshot {
+  std::array<std::uint64_t, LoggerLevelCount> enqueued{};  // Indexed by LogLevel
+  std::array<std::uint64_t, LoggerLevelCount> written{};
+  std::uint64_t dropped = 0;
+  std::uint64_t queueHighWater = 0;  // Most records waiting at once, as seen by the worker
+  LoggerLatencySummary enqueueToWrite;  // Producer timestamp to the end of the last sink write
+  LoggerLatencySummary sinkWrite;       // One record through every sink accepting it
+  LoggerLatencySummary sinkFlush;       // One flush pass over the sinks, where files hit the disk
+};
+
+// Counters behind LoggerThread metrics. Producers only touch the enqueued counter of their
+// level, each on its own cache line, everything else is updated by the worker.
+struct LoggerMetrics {
+  struct alignas(LoggerCacheLineSize) PaddedCounter {
+    std::atomic<std::uint64_t> value{0};
+  };
+
+  void countEnqueued(LogLevel level) {
+    enqueued[static_cast<std::size_t>(level)].value.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void countWritten(LogLevel level) {
+    written[static_cast<std::size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void updateQueueHighWater(std::uint64_t depth) {
+    if (depth > queueHighWater.load(std::memory_order_relaxed)) {
+      queueHighWater.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  LoggerMetricsSnapshot snapshot() const {
+    LoggerMetricsSnapshot result;
+    for (std::size_t i = 0; i < LoggerLevelCount; ++i) {
+      result.enqueued[i] = enqueued[i].value.load(std::memory_order_relaxed);
+      result.written[i] = written[i].load(std::memory_order_relaxed);
+    }
+    result.queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+    result.enqueueToWrite = enqueueToWrite.summary();
+    result.sinkWrite = sinkWrite.summary();
+    result.sinkFlush = sinkFlush.summary();
+    return result;
+  }
+
+  std::array<PaddedCounter, LoggerLevelCount> enqueued;
+  std::array<std::atomic<std::uint64_t>, LoggerLevelCount> written{};
+  std::atomic<std::uint64_t> queueHighWater{0};
+  LoggerLatencyHistogram enqueueToWrite;
+  LoggerLatencyHistogram sinkWrite;
+  LoggerLatencyHistogram sinkFlush;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Per call site state of LOGGER_THREAD_EVERY_N, LOGGER_THREAD_ONCE and LOGGER_THREAD_RATE.
+// Each macro keeps one of these in a constinit static. A suppressed call costs one atomic
+// operation, its arguments are never evaluated and nothing reaches the queue.
+
+struct LoggerEveryN {
+  // True for the first call and every nth one after it
+  bool allow(std::uint64_t n) {
+    std::uint64_t call = count.fetch_add(1, std::memory_order_relaxed);
+    return n <= 1 || call % n == 0;
+  }
+
+  std::atomic<std::uint64_t> count{0};
+};
+
+struct LoggerOnce {
+  bool allow() {
+    return !done.load(std::memory_order_relaxed) &&
+           !done.exchange(true, std::memory_order_relaxed);
+  }
+
+  std::atomic<bool> done{false};
+};
+
+// Generic cell rate algorithm: perSecond calls go through per second on average, bursts of up
+// to perSecond calls go through at once. State is the time the next call is due, so the
+// allowed path is a clock read and one compare and swap.
+struct LoggerRateLimiter {
+  bool allow(double perSecond) {
+    if (!(perSecond > 0)) {
+      return false;
+    }
+    auto interval = static_cast<std::int64_t>(1e9 / perSecond);
+    std::int64_t tolerance = interval * (std::max<std::int64_t>(
+                                             static_cast<std::int64_t>(perSecond), 1) - 1);
+    std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+    std::int64_t due = next.load(std::memory_order_relaxed);
+    while (true) {
+      std::int64_t start = std::max(due, now);
+      if (start - now > tolerance) {
+        return false;
+      }
+      if (next.compare_exchange_weak(due, start + interval, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  std::atomic<std::int64_t> next{0};
+};
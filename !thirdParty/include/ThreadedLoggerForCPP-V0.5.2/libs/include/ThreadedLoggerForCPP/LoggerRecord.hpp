@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "LoggerArgs.hpp"
+
+enum class LogLevel { INFO, WARNING, ERRORING, LOGICERROR };
+
+inline constexpr std::size_t LoggerCacheLineSize = 64;
+
+// One static instance per LOGGER_THREAD call site. Records only carry a pointer to it,
+// the path relative to LoggerGlobals::SrcProjectDirectory is resolved once by the worker.
+struct LoggerCallSite {
+  constexpr LoggerCallSite(const char *sourceFile, int sourceLine)
+      : file(sourceFile),
+        fileSize(std::char_traits<char>::length(sourceFile)),
+        fileNameOffset(findFileNameOffset(sourceFile)),
+        line(sourceLine) {}
+
+  const char *file;
+  std::size_t fileSize;
+  std::size_t fileNameOffset;  // Position of the last path separator, computed at compile time
+  int line;
+  mutable std::atomic<int> relativeOffset{-1};  // Filled in on first use by the worker
+
+ private:
+  static constexpr std::size_t findFileNameOffset(const char *path) {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; path[i] != '\0'; ++i) {
+      if (path[i] == '/' || path[i] == '\\') {
+        offset = i;
+      }
+    }
+    return offset;
+  }
+};
+
+// Fixed-size log record stored inline in the ring buffer slots.
+// The payload holds the source file (only when there is no call site) followed by the
+// arguments encoded by LoggerArgs, arguments that do not fit are cut and the formatted
+// message ends with "...".
+struct LogRecord {
+  static constexpr std::size_t PayloadCapacity = 456;
+
+  std::uint64_t timestamp;  // Raw LoggerClock ticks captured by the producer
+  const LoggerCallSite *callSite;
+  LogLevel level;
+  int line;
+  std::uint16_t fileSize;
+  std::uint16_t argsSize;
+  bool truncated;
+  bool span;  // LOGGER_TRACE_SCOPE span: name, start ticks and thread index, see LoggerTraceSink
+  std::uint16_t category;  // LoggerCategory id, 0 for records logged without one and
+                           // LoggerSink::AnyCategory for the reports of the worker
+  char payload[PayloadCapacity];
+
+  std::string_view file() const {
+    if (callSite != nullptr) {
+      return std::string_view(callSite->file, callSite->fileSize);
+    }
+    return std::string_view(payload, fileSize);
+  }
+
+  std::string_view args() const { return std::string_view(payload + fileSize, argsSize); }
+
+  void begin(
+      LogLevel recordLevel, std::string_view sourceFile, int sourceLine, std::uint64_t ticks) {
+    timestamp = ticks;
+    callSite = nullptr;
+    level = recordLevel;
+    line = sourceLine;
+    // Keep the end of the path, the part extractRelativePath cares about
+    if (sourceFile.size() > PayloadCapacity / 2) {
+      sourceFile.remove_prefix(sourceFile.size() - PayloadCapacity / 2);
+    }
+    std::memcpy(payload, sourceFile.data(), sourceFile.size());
+    fileSize = static_cast<std::uint16_t>(sourceFile.size());
+    argsSize = 0;
+    truncated = false;
+    span = false;
+    category = 0;
+  }
+
+  void begin(LogLevel recordLevel, const LoggerCallSite &site, std::uint64_t ticks) {
+    timestamp = ticks;
+    callSite = &site;
+    level = recordLevel;
+    line = site.line;
+    fileSize = 0;
+    argsSize = 0;
+    truncated = false;
+    span = false;
+    category = 0;
+  }
+
+  template <typename T>
+  void push(const T &value) {
+    std::size_t used = fileSize + argsSize;
+    argsSize += static_cast<std::uint16_t>(
+        LoggerArgs::encode(payload + used, PayloadCapacity - used, value, truncated));
+  }
+
+  // Key/value pairs of LOGGER_THREAD_KV, keys are copied in as KEY arguments
+  template <typename Key, typename Value, typename... Rest>
+  void pushFields(const Key &key, const Value &value, const Rest &...rest) {
+    std::size_t used = fileSize + argsSize;
+    argsSize += static_cast<std::uint16_t>(LoggerArgs::encodeString(
+        payload + used, PayloadCapacity - used, std::string_view(key), truncated,
+        LogArgType::KEY));
+    push(value);
+    if constexpr (sizeof...(Rest) > 0) {
+      pushFields(rest...);
+    }
+  }
+
+  // Same call site, level and argument bytes, the formatted text would only differ in the time
+  bool sameMessage(const LogRecord &other) const {
+    return callSite == other.callSite && level == other.level && line == other.line &&
+           fileSize == other.fileSize && argsSize == other.argsSize &&
+           truncated == other.truncated && span == other.span &&
+           category == other.category &&
+           std::memcmp(payload, other.payload, fileSize + argsSize) == 0;
+  }
+
+  void appendMessage(std::string &out) const {
+    LoggerArgs::appendText(out, args());
+    if (truncated) {
+      out.append("...");
+    }
+  }
+};
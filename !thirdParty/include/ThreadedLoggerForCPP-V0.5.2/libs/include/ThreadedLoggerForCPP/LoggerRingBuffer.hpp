@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "LoggerRecord.hpp"
+
+// Bounded ring buffer of LogRecord slots (Vyukov style sequence numbers).
+// Multi producer, multi consumer: any thread can push or pop. The logger worker is the usual
+// consumer, but LoggerThread::handleFullQueue pops from producers for DROP_OLDEST.
+// Slots are allocated once in the constructor, pushing only claims a slot
+// with a single CAS on the enqueue cursor and fills the record in place.
+class LoggerRingBuffer {
+ public:
+  struct alignas(LoggerCacheLineSize) Slot {
+    std::atomic<std::size_t> sequence;
+    LogRecord record;
+  };
+  static_assert(sizeof(Slot) % LoggerCacheLineSize == 0, "Slot must be cache-line padded");
+
+  explicit LoggerRingBuffer(std::size_t capacity)
+      : mask(roundUpToPowerOfTwo(capacity) - 1), slots(new Slot[mask + 1]) {
+    for (std::size_t i = 0; i <= mask; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LoggerRingBuffer(const LoggerRingBuffer &) = delete;
+  LoggerRingBuffer &operator=(const LoggerRingBuffer &) = delete;
+
+  // Calls fill(LogRecord &) on a free slot, returns false when the ring is full
+  template <typename Fill>
+  bool tryPush(Fill &&fill) {
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+      slot = &slots[pos & mask];
+      std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+      std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    fill(slot->record);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Calls consume(const LogRecord &) on the oldest record, returns false when empty
+  template <typename Consume>
+  bool tryPop(Consume &&consume) {
+    std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+      slot = &slots[pos & mask];
+      std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+      std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+    consume(static_cast<const LogRecord &>(slot->record));
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    return slots[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  // Same test tryPush fails on, a slot only frees once its consumer has returned
+  bool full() const {
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    std::size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+    return static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos) < 0;
+  }
+
+  // Approximate while producers and the consumer are running
+  std::size_t size() const {
+    std::size_t head = dequeuePos.load(std::memory_order_relaxed);
+    std::size_t tail = enqueuePos.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  std::size_t capacity() const { return mask + 1; }
+
+  static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+ private:
+  const std::size_t mask;
+  std::unique_ptr<Slot[]> slots;
+  alignas(LoggerCacheLineSize) std::atomic<std::size_t> enqueuePos{0};
+  alignas(LoggerCacheLineSize) std::atomic<std::size_t> dequeuePos{0};
+};
+
+// Single producer ring used for the per-thread queues. Producer and consumer each own
+// one cursor on its own cache line and keep a cached copy of the other one.
+class LoggerSpscRingBuffer {
+ public:
+  struct alignas(LoggerCacheLineSize) Slot {
+    LogRecord record;
+  };
+
+  explicit LoggerSpscRingBuffer(std::size_t capacity)
+      : mask(LoggerRingBuffer::roundUpToPowerOfTwo(capacity) - 1), slots(new Slot[mask + 1]) {}
+
+  LoggerSpscRingBuffer(const LoggerSpscRingBuffer &) = delete;
+  LoggerSpscRingBuffer &operator=(const LoggerSpscRingBuffer &) = delete;
+
+  // Producer thread only
+  template <typename Fill>
+  bool tryPush(Fill &&fill) {
+    std::size_t pos = tail.load(std::memory_order_relaxed);
+    if (pos - cachedHead > mask) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (pos - cachedHead > mask) {
+        return false;
+      }
+    }
+    fill(slots[pos & mask].record);
+    tail.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only, nullptr when empty
+  const LogRecord *front() {
+    std::size_t pos = head.load(std::memory_order_relaxed);
+    if (pos == cachedTail) {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if (pos == cachedTail) {
+        return nullptr;
+      }
+    }
+    return &slots[pos & mask].record;
+  }
+
+  // Consumer thread only, releases the record returned by front
+  void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  std::size_t size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+  }
+
+  // Producer thread only
+  bool full() const { return tail.load(std::memory_order_relaxed) - head.load() > mask; }
+
+ private:
+  const std::size_t mask;
+  std::unique_ptr<Slot[]> slots;
+  alignas(LoggerCacheLineSize) std::atomic<std::size_t> tail{0};
+  std::size_t cachedHead = 0;  // Producer side copy of head
+  alignas(LoggerCacheLineSize) std::atomic<std::size_t> head{0};
+  std::size_t cachedTail = 0;  // Consumer side copy of tail
+};
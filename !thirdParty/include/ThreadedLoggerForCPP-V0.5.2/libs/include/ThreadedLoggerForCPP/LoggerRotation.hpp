@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "LoggerSink.hpp"
+
+// When the log file is moved to the backup folder, 0 disables a trigger
+struct LoggerRotationPolicy {
+  std::uint64_t maxFileBytes = 64 * 1024 * 1024;  // Rotate once the file reaches this size
+  std::chrono::seconds maxAge{0};                 // Rotate files older than this
+  std::size_t maxBackups = 10;                    // Oldest backups beyond this are deleted
+  bool archiveOnExit = true;                      // ExitLoggerThread moves the file as well
+  // Optional, called with the path of every new backup on a low priority thread.
+  // It may replace the file (game-1.log -> game-1.log.gz), keep the backup prefix in the name.
+  std::function<void(const std::string &path)> compress;
+};
+
+// Background work on rotated files: compression hook first, then pruning of old backups.
+// Runs on its own low priority thread so the logger worker only pays for a rename.
+class LoggerArchiver {
+ public:
+  LoggerArchiver(std::string backupPrefix, LoggerRotationPolicy rotationPolicy)
+      : prefix(std::move(backupPrefix)), policy(std::move(rotationPolicy)) {}
+
+  ~LoggerArchiver() {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      done = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable()) {
+      worker.join();  // Finishes the queued backups, each one is at most maxFileBytes
+    }
+  }
+
+  LoggerArchiver(const LoggerArchiver &) = delete;
+  LoggerArchiver &operator=(const LoggerArchiver &) = delete;
+
+  void add(std::string backupPath) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      pending.push_back(std::move(backupPath));
+      if (!worker.joinable()) {
+        worker = std::thread(&LoggerArchiver::run, this);
+      }
+    }
+    wakeUp.notify_one();
+  }
+
+  // Renames path to "<prefix><timestamp>.log", a counter is added when the name is taken.
+  // Returns the new name, empty when there was nothing to move or the rename failed, error
+  // tells the two apart.
+  static std::string archive(
+      const std::string &path, const std::string &backupPrefix, std::error_code &error) {
+    if (std::filesystem::file_size(path, error) == 0 || error) {
+      error.clear();
+      return {};
+    }
+    std::string base = backupPrefix + timestamp();
+    std::string backup = base + ".log";
+    for (int suffix = 1; std::filesystem::exists(backup, error); ++suffix) {
+      backup = base + "-" + std::to_string(suffix) + ".log";
+    }
+    error.clear();
+    std::filesystem::rename(path, backup, error);
+    return error ? std::string() : backup;
+  }
+
+  // Deletes the oldest files starting with backupPrefix until maxBackups are left
+  static void prune(const std::string &backupPrefix, std::size_t maxBackups) {
+    std::filesystem::path prefixPath(backupPrefix);
+    std::filesystem::path folder = prefixPath.parent_path();
+    std::string namePrefix = prefixPath.filename().string();
+    std::error_code error;
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> backups;
+    for (const auto &entry : std::filesystem::directory_iterator(
+             folder.empty() ? std::filesystem::path(".") : folder, error)) {
+      std::string name = entry.path().filename().string();
+      if (entry.is_regular_file(error) && name.compare(0, namePrefix.size(), namePrefix) == 0) {
+        backups.emplace_back(entry.last_write_time(error), entry.path());
+      }
+    }
+    if (backups.size() <= maxBackups) {
+      return;
+    }
+    std::sort(backups.begin(), backups.end());
+    for (std::size_t i = 0; i < backups.size() - maxBackups; ++i) {
+      std::filesystem::remove(backups[i].second, error);
+    }
+  }
+
+ private:
+  static std::string timestamp() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    struct tm timeinfo;
+#ifdef _WIN32
+    localtime_s(&timeinfo, &now);
+#else
+    localtime_r(&now, &timeinfo);
+#endif
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d-%H-%M-%S", &timeinfo);
+    return buffer;
+  }
+
+  void run() {
+#ifdef __linux__
+    setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 19);  // Nice value is per thread
+#endif
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      wakeUp.wait(lock, [this] { return done || !pending.empty(); });
+      if (pending.empty()) {
+        return;
+      }
+      std::string backup = std::move(pending.front());
+      pending.pop_front();
+      lock.unlock();
+      // Pruning can remove queued backups when rotations outrun the compression hook
+      std::error_code error;
+      if (policy.compress && std::filesystem::exists(backup, error)) {
+        policy.compress(backup);
+      }
+      prune(prefix, policy.maxBackups);
+      lock.lock();
+    }
+  }
+
+  const std::string prefix;
+  const LoggerRotationPolicy policy;
+  std::mutex mtx;
+  std::condition_variable wakeUp;
+  std::deque<std::string> pending;  // Guarded by mtx
+  bool done = false;                // Guarded by mtx
+  std::thread worker;
+};
+
+// Log file sink that moves its file to "<backupPrefix><timestamp>.log" with a rename
+// when the size or age limit is hit, then starts a fresh file under the same path.
+class LoggerRotatingFileSink : public LoggerWriterSink {
+ public:
+  LoggerRotatingFileSink(
+      const std::string &filePath,
+      const std::string &backupPrefix,
+      const LoggerRotationPolicy &rotationPolicy,
+      bool truncate,
+      LogLevel level = LogLevel::INFO)
+      : LoggerWriterSink(level),
+        path(filePath),
+        prefix(backupPrefix),
+        policy(rotationPolicy),
+        archiver(backupPrefix, rotationPolicy) {
+    writer.open(path, truncate);
+    openedAt = std::chrono::steady_clock::now();
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+
+  void write(LoggerFormatter &formatter) override {
+    LoggerWriterSink::write(formatter);
+    if (policy.maxFileBytes > 0 && writer.size() >= rotateAtBytes) {
+      rotate(true);
+    }
+  }
+
+  void flushIfDue(bool queueEmpty) override {
+    LoggerWriterSink::flushIfDue(queueEmpty);
+    if (policy.maxAge.count() > 0 && writer.size() > 0 &&
+        std::chrono::steady_clock::now() - openedAt >= policy.maxAge) {
+      rotate(true);
+    }
+  }
+
+  void archive() override {
+    if (policy.archiveOnExit) {
+      rotate(false);
+    }
+  }
+
+ private:
+  void rotate(bool reopen) {
+    writer.close();
+    std::error_code error;
+    std::string backup = LoggerArchiver::archive(path, prefix, error);
+    if (error) {
+      std::cerr << "Error: Unable to move " << path << " to its backup: " << error.message()
+                << ", appending to it.\n";
+    }
+    if (reopen) {
+      // Truncating is only safe once the records were moved away
+      writer.open(path, !error);
+      openedAt = std::chrono::steady_clock::now();
+      // After a failure the next attempt waits for another maxFileBytes
+      rotateAtBytes = error ? writer.size() + policy.maxFileBytes : policy.maxFileBytes;
+    }
+    if (!backup.empty()) {
+      archiver.add(std::move(backup));
+    }
+  }
+
+  const std::string path;
+  const std::string prefix;
+  const LoggerRotationPolicy policy;
+  std::chrono::steady_clock::time_point openedAt;
+  std::uint64_t rotateAtBytes = policy.maxFileBytes;
+  LoggerArchiver archiver;
+};
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "LoggerBinaryFormat.hpp"
+#include "LoggerFileWriter.hpp"
+#include "LoggerFormatter.hpp"
+#include "LoggerRecord.hpp"
+
+// Output of the logger worker. Every sink filters on its own level and decides how a
+// record is formatted, all calls except setLevel happen on the worker thread.
+class LoggerSink {
+ public:
+  static constexpr std::uint16_t AnyCategory = 0xffff;
+
+  explicit LoggerSink(LogLevel level = LogLevel::INFO) : minLevel(level) {}
+
+  virtual ~LoggerSink() = default;
+
+  void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+
+  bool accepts(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+  bool accepts(const LogRecord &record) const {
+    if (record.span) {
+      return acceptsSpans();
+    }
+    // Reports of the worker itself (drops, metrics) are tagged AnyCategory and reach every sink
+    std::uint16_t wanted = category.load(std::memory_order_relaxed);
+    return accepts(record.level) &&
+           (wanted == AnyCategory || record.category == AnyCategory || wanted == record.category);
+  }
+
+  // Restricts the sink to the records of one LoggerCategory, see LoggerCategoryPool
+  void setCategory(std::uint16_t id) { category.store(id, std::memory_order_relaxed); }
+
+  // Spans of LOGGER_TRACE_SCOPE only go to sinks returning true, see LoggerTraceSink
+  virtual bool acceptsSpans() const { return false; }
+
+  virtual void write(LoggerFormatter &formatter) = 0;
+
+  virtual void setFlushPolicy(const LoggerFlushPolicy &) {}
+
+  // Called between batches, queueEmpty tells whether the worker is about to go idle
+  virtual void flushIfDue(bool) {}
+
+  virtual void flush() {}
+
+  // Called by ExitLoggerThread once the last record is written
+  virtual void archive() {}
+
+  // Writes out what the sink only keeps in memory, see LoggerFlightRecorderSink
+  virtual void dump() {}
+
+ private:
+  std::atomic<LogLevel> minLevel;
+  std::atomic<std::uint16_t> category{AnyCategory};
+};
+
+// Base for sinks writing text lines through a batching LoggerFileWriter.
+// Override format to change the line layout.
+class LoggerWriterSink : public LoggerSink {
+ public:
+  using LoggerSink::LoggerSink;
+
+  void write(LoggerFormatter &formatter) override {
+    writer.writeLine(format(formatter), formatter.record().level);
+  }
+
+  void setFlushPolicy(const LoggerFlushPolicy &policy) override { writer.setPolicy(policy); }
+
+  void flushIfDue(bool queueEmpty) override { writer.flushIfDue(queueEmpty); }
+
+  void flush() override { writer.flush(); }
+
+ protected:
+  virtual std::string_view format(LoggerFormatter &formatter) { return formatter.text(); }
+
+  LoggerFileWriter writer;
+};
+
+class LoggerFileSink : public LoggerWriterSink {
+ public:
+  LoggerFileSink(const std::string &path, bool truncate, LogLevel level = LogLevel::INFO)
+      : LoggerWriterSink(level) {
+    writer.open(path, truncate);
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+};
+
+class LoggerConsoleSink : public LoggerWriterSink {
+ public:
+  explicit LoggerConsoleSink(LogLevel level = LogLevel::INFO, bool useStderr = false)
+      : LoggerWriterSink(level) {
+    writer.attach(useStderr ? 2 : 1);
+  }
+};
+
+// Accepts everything and writes nothing, for measuring the logger itself
+class LoggerNullSink : public LoggerSink {
+ public:
+  using LoggerSink::LoggerSink;
+
+  void write(LoggerFormatter &) override {
+    written.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::uint64_t recordsWritten() const { return written.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint64_t> written{0};
+};
+
+// Writes records in the LoggerBinaryFormat layout instead of text, the worker only
+// copies ids and argument values. Read the file back with the logdecode tool.
+class LoggerBinarySink : public LoggerSink {
+ public:
+  LoggerBinarySink(const std::string &path, bool truncate, LogLevel level = LogLevel::INFO)
+      : LoggerSink(level) {
+    if (writer.open(path, truncate)) {
+      writer.write(LoggerBinaryFormat::Magic, LogLevel::INFO);
+    }
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+
+  void write(LoggerFormatter &formatter) override {
+    entry.clear();
+    encoder.append(entry, formatter);
+    writer.write(entry, formatter.record().level);
+  }
+
+  void setFlushPolicy(const LoggerFlushPolicy &policy) override { writer.setPolicy(policy); }
+
+  void flushIfDue(bool queueEmpty) override { writer.flushIfDue(queueEmpty); }
+
+  void flush() override { writer.flush(); }
+
+ private:
+  LoggerFileWriter writer;
+  LoggerBinaryEncoder encoder;
+  std::string entry;
+};
+
+// One JSON object per line for log pipelines:
+//   {"ts":1760000000000000000,"level":"INFO","file":"src/app.cpp","line":42,"msg":"frame",
+//    "ms":16.6,"draws":120}
+// ts is in nanoseconds since the epoch. LOGGER_THREAD_KV fields keep their type, every other
+// record only has msg. The line is built in a buffer reused across records.
+class LoggerJsonSink : public LoggerWriterSink {
+ public:
+  LoggerJsonSink(const std::string &path, bool truncate, LogLevel level = LogLevel::INFO)
+      : LoggerWriterSink(level) {
+    writer.open(path, truncate);
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+
+  static void appendEscaped(std::string &out, std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : text) {
+      switch (c) {
+        case '"':
+          out.append("\\\"");
+          break;
+        case '\\':
+          out.append("\\\\");
+          break;
+        case '\n':
+          out.append("\\n");
+          break;
+        case '\r':
+          out.append("\\r");
+          break;
+        case '\t':
+          out.append("\\t");
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            out.append("\\u00");
+            out.push_back(hex[(c >> 4) & 0xf]);
+            out.push_back(hex[c & 0xf]);
+          } else {
+            out.push_back(c);
+          }
+      }
+    }
+    out.push_back('"');
+  }
+
+  static std::string_view levelName(LogLevel level) {
+    switch (level) {
+      case LogLevel::INFO:
+        return "INFO";
+      case LogLevel::WARNING:
+        return "WARNING";
+      case LogLevel::ERRORING:
+        return "ERROR";
+      case LogLevel::LOGICERROR:
+        return "LOGIC_ERROR";
+    }
+    return "";
+  }
+
+ protected:
+  std::string_view format(LoggerFormatter &formatter) override {
+    const LogRecord &record = formatter.record();
+    line.clear();
+    line.append("{\"ts\":");
+    appendNumber(formatter.systemNanoseconds());
+    line.append(",\"level\":\"");
+    line.append(levelName(record.level));
+    line.append("\",\"file\":");
+    appendEscaped(line, formatter.relativePath());
+    line.append(",\"line\":");
+    appendNumber(record.line);
+
+    // Everything before the first key is the message
+    std::string_view args = record.args();
+    const char *it = args.data();
+    const char *end = it + args.size();
+    while (it < end && static_cast<LogArgType>(*it) != LogArgType::KEY) {
+      if (!LoggerArgs::skipValue(it)) {
+        it = end;
+      }
+    }
+    if (it >= end) {
+      line.append(",\"msg\":");
+      appendEscaped(line, formatter.message());
+    } else {
+      message.clear();
+      LoggerArgs::appendText(
+          message, std::string_view(args.data(), static_cast<std::size_t>(it - args.data())));
+      line.append(",\"msg\":");
+      appendEscaped(line, message);
+      appendFields(it, end);
+      if (record.truncated) {
+        line.append(",\"truncated\":true");
+      }
+    }
+    line.push_back('}');
+    return line;
+  }
+
+ private:
+  template <typename T>
+  void appendNumber(T value) {
+    char number[32];
+    auto result = std::to_chars(number, number + sizeof(number), value);
+    line.append(number, result.ptr);
+  }
+
+  // Writes ,"key":value for every KEY argument, a value cut from a full record becomes null
+  void appendFields(const char *it, const char *end) {
+    while (it < end) {
+      auto type = static_cast<LogArgType>(*it++);
+      if (type != LogArgType::KEY) {
+        --it;
+        if (!LoggerArgs::skipValue(it)) {
+          return;
+        }
+        continue;
+      }
+      auto size = LoggerArgs::read<std::uint16_t>(it);
+      line.push_back(',');
+      appendEscaped(line, std::string_view(it, size));
+      line.push_back(':');
+      it += size;
+      if (it == end || static_cast<LogArgType>(*it) == LogArgType::KEY) {
+        line.append("null");
+        continue;
+      }
+      if (!appendValue(it)) {
+        return;
+      }
+    }
+  }
+
+  bool appendValue(const char *&it) {
+    switch (static_cast<LogArgType>(*it++)) {
+      case LogArgType::INT:
+        appendNumber(LoggerArgs::read<std::int64_t>(it));
+        break;
+      case LogArgType::UINT:
+        appendNumber(LoggerArgs::read<std::uint64_t>(it));
+        break;
+      case LogArgType::DOUBLE: {
+        double value = LoggerArgs::read<double>(it);
+        if (std::isfinite(value)) {
+          appendNumber(value);
+        } else {
+          line.append("null");  // JSON has no NaN or infinity
+        }
+        break;
+      }
+      case LogArgType::BOOL:
+        line.append(LoggerArgs::read<bool>(it) ? "true" : "false");
+        break;
+      case LogArgType::CHAR: {
+        char value = LoggerArgs::read<char>(it);
+        appendEscaped(line, std::string_view(&value, 1));
+        break;
+      }
+      case LogArgType::STRING: {
+        auto size = LoggerArgs::read<std::uint16_t>(it);
+        appendEscaped(line, std::string_view(it, size));
+        it += size;
+        break;
+      }
+      case LogArgType::LITERAL:
+        appendEscaped(line, LoggerArgs::read<const char *>(it));
+        break;
+      default:
+        line.append("null");
+        return false;
+    }
+    return true;
+  }
+
+  std::string line;
+  std::string message;
+};
+
+// Stands in for a sink that could not be opened. Records go to a fallback file kept open
+// for the whole session, and every retryInterval the primary sink is opened again. Once
+// that works the fallback file is closed and everything is forwarded to the primary.
+class LoggerFallbackSink : public LoggerWriterSink {
+ public:
+  // openPrimary returns nullptr while the primary output is still unavailable
+  using PrimaryFactory = std::function<std::unique_ptr<LoggerSink>()>;
+
+  LoggerFallbackSink(
+      const std::string &fallbackPath,
+      PrimaryFactory openPrimary,
+      std::chrono::milliseconds retryInterval = std::chrono::seconds(5),
+      LogLevel level = LogLevel::INFO)
+      : LoggerWriterSink(level),
+        factory(std::move(openPrimary)),
+        interval(retryInterval),
+        lastAttempt(std::chrono::steady_clock::now()) {
+    writer.open(fallbackPath, false);
+  }
+
+  bool usingPrimary() const { return primary != nullptr; }
+
+  void write(LoggerFormatter &formatter) override {
+    if (primary != nullptr) {
+      primary->write(formatter);
+    } else {
+      LoggerWriterSink::write(formatter);
+    }
+  }
+
+  void setFlushPolicy(const LoggerFlushPolicy &policy) override {
+    flushPolicy = policy;
+    hasFlushPolicy = true;
+    if (primary != nullptr) {
+      primary->setFlushPolicy(policy);
+    } else {
+      LoggerWriterSink::setFlushPolicy(policy);
+    }
+  }
+
+  void flushIfDue(bool queueEmpty) override {
+    if (primary != nullptr) {
+      primary->flushIfDue(queueEmpty);
+      return;
+    }
+    LoggerWriterSink::flushIfDue(queueEmpty);
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastAttempt >= interval) {
+      lastAttempt = now;
+      retryPrimary();
+    }
+  }
+
+  void flush() override {
+    if (primary != nullptr) {
+      primary->flush();
+    } else {
+      LoggerWriterSink::flush();
+    }
+  }
+
+  void archive() override {
+    if (primary != nullptr) {
+      primary->archive();
+    }
+  }
+
+  void dump() override {
+    if (primary != nullptr) {
+      primary->dump();
+    }
+  }
+
+ private:
+  void retryPrimary() {
+    primary = factory();
+    if (primary == nullptr) {
+      return;
+    }
+    if (hasFlushPolicy) {
+      primary->setFlushPolicy(flushPolicy);
+    }
+    writer.close();
+  }
+
+  PrimaryFactory factory;
+  const std::chrono::milliseconds interval;
+  std::chrono::steady_clock::time_point lastAttempt;
+  std::unique_ptr<LoggerSink> primary;
+  LoggerFlushPolicy flushPolicy;
+  bool hasFlushPolicy = false;
+};
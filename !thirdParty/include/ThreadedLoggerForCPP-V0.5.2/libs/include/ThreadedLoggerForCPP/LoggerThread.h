@@ -1,29 +1,120 @@
 #ifndef LOGGER_THREAD_HPP
 #define LOGGER_THREAD_HPP
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <vector>
 
+#include "LoggerBinaryFormat.hpp"
+#include "LoggerClock.hpp"
 #include "LoggerFileSystem.hpp"
+#include "LoggerFileWriter.hpp"
+#include "LoggerFlightRecorder.hpp"
+#include "LoggerFormatter.hpp"
 #include "LoggerGlobals.hpp"
+#include "LoggerMetrics.hpp"
+#include "LoggerRateLimit.hpp"
+#include "LoggerRecord.hpp"
+#include "LoggerRingBuffer.hpp"
+#include "LoggerRotation.hpp"
+#include "LoggerSink.hpp"
+#include "LoggerTrace.hpp"
+
+// Calls to LOGGER_THREAD below this level are compiled out, arguments included.
+// 0 = INFO, 1 = WARNING, 2 = ERRORING, 3 = LOGICERROR, 4 = nothing.
+#ifndef LOGGER_THREAD_MIN_LEVEL
+#define LOGGER_THREAD_MIN_LEVEL 0
+#endif
+
+// 0 compiles LOGGER_TRACE_SCOPE out, 1 keeps it behind LoggerThread::EnableTracing
+#ifndef LOGGER_THREAD_TRACING
+#define LOGGER_THREAD_TRACING 1
+#endif
+
+// SHARED: every producer pushes into one ring.
+// PER_THREAD: every producer thread gets its own single producer ring on first use and
+// the worker merges them by capture timestamp.
+enum class LoggerQueueMode { SHARED, PER_THREAD };
+
+// What a producer does when its queue is full.
+// BLOCK: wait for the worker, nothing is lost.
+// DROP_NEWEST: the new record is dropped.
+// DROP_OLDEST: the oldest queued record is dropped to make room, per-thread rings only have
+// one consumer so they drop the new record instead.
+// DROP_BELOW_LEVEL: records below the given level are dropped, the others wait.
+enum class LoggerOverflowPolicy { BLOCK, DROP_NEWEST, DROP_OLDEST, DROP_BELOW_LEVEL };
+
+// How the worker thread waits and where it runs. cpu and niceValue are only applied on Linux.
+struct LoggerWorkerOptions {
+  int cpu = -1;                  // Pin the worker to this CPU, -1 leaves the affinity alone
+  int niceValue = 0;             // Above 0 the worker gives way to the game and render threads
+  std::uint32_t maxSpin = 1024;  // Polls for new records before parking, 0 parks at once
+};
 
-enum class LogLevel { INFO, WARNING, ERRORING, LOGICERROR };
+// Queue of one producer thread in LoggerQueueMode::PER_THREAD
+struct LoggerThreadBuffer {
+  explicit LoggerThreadBuffer(std::size_t capacity) : ring(capacity) {}
+
+  LoggerSpscRingBuffer ring;
+  std::atomic<bool> producerExited{false};
+};
+
+// Buffers of the calling thread, one per logger instance it logs to. On thread exit
+// they are flagged so the worker drains what is left before dropping them.
+struct LoggerThreadBufferCache {
+  ~LoggerThreadBufferCache() {
+    for (auto &entry : entries) {
+      entry.second->producerExited.store(true, std::memory_order_release);
+    }
+  }
+
+  std::vector<std::pair<std::uint64_t, std::shared_ptr<LoggerThreadBuffer>>> entries;
+};
 
 class LoggerThread {
+ public:
+  // Shared by both branches below, the disabled logger keeps the same signatures
+  static constexpr std::size_t DefaultQueueCapacity = 4096;
+  static constexpr std::size_t DefaultThreadQueueCapacity = 1024;
+  // With LoggerOverflowPolicy::BLOCK a producer finding its queue full retries this many
+  // times, waking the worker and pausing or yielding in between, before it parks until the
+  // worker frees slots. A burst usually clears within the spin, a disk stall does not, and a
+  // parked producer costs no CPU while it waits.
+  static constexpr int BlockSpinLimit = 64;
+
 #if defined(_WIN32) || defined(__linux__) || !defined(__ANDROID__) || !defined(EMSCRIPTEN) || \
     !defined(__NINTENDO__) || !defined(TARGET_OS_IPHONE)
 
  public:
-  LoggerThread() : Done_Logger_Thread(false), useFallback(false) {
+  static constexpr std::chrono::seconds DropReportInterval{1};
+  static constexpr std::chrono::milliseconds DefaultShutdownTimeout{3000};
+  static constexpr std::chrono::seconds RepeatReportInterval{1};
+
+  LoggerThread() : LoggerThread(LoggerClockSource::SYSTEM) {}
+
+  // TSC or MONOTONIC_COARSE make the producer side timestamp capture cheaper than system_clock.
+  // The shared queue holds queueCapacity records (rounded up to a power of two), that is all
+  // the memory the logger takes no matter how fast messages come in.
+  explicit LoggerThread(
+      LoggerClockSource clockSource, std::size_t queueCapacity = DefaultQueueCapacity)
+      : records(queueCapacity),
+        Done_Logger_Thread(false),
+        clock(clockSource),
+        formatter(clock),
+        instanceId(NextInstanceId.fetch_add(1, std::memory_order_relaxed)) {
+    pendingSinks.push_back(std::make_unique<LoggerConsoleSink>());
     workerThread = std::thread(&LoggerThread::logWorker, this);
   }
 
@@ -47,6 +138,108 @@ class LoggerThread {
       int line,
       const std::initializer_list<std::string> &messageParts);
 
+  // Arguments are copied into the record as binary, the text is formatted by the worker
+  template <typename... Args>
+  void logAsync(LogLevel level, std::string_view sourceFile, int line, const Args &...args) {
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+    enqueue(level, [&](LogRecord &record) {
+      record.begin(level, sourceFile, line, clock.now());
+      (record.push(args), ...);
+    });
+  }
+
+  // Used by LOGGER_THREAD, the record keeps a pointer to the static call site
+  template <typename... Args>
+  void logAsync(LogLevel level, const LoggerCallSite &site, const Args &...args) {
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+    enqueue(level, [&](LogRecord &record) {
+      record.begin(level, site, clock.now());
+      (record.push(args), ...);
+    });
+  }
+
+  // Used by LOGGER_THREAD_CATEGORY, only sinks restricted to this category or to none get
+  // the record, see LoggerCategoryPool
+  template <typename... Args>
+  void logCategory(
+      LogLevel level, const LoggerCallSite &site, std::uint16_t category, const Args &...args) {
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+    enqueue(level, [&](LogRecord &record) {
+      record.begin(level, site, clock.now());
+      record.category = category;
+      (record.push(args), ...);
+    });
+  }
+
+  // Used by LOGGER_THREAD_FORMAT, the pattern is stored as a pointer and filled in by the
+  // worker, see LoggerBasicFormatString
+  template <typename... Args>
+  void logFormat(
+      LogLevel level,
+      const LoggerCallSite &site,
+      LoggerFormatString<Args...> format,
+      const Args &...args) {
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+    enqueue(level, [&](LogRecord &record) {
+      record.begin(level, site, clock.now());
+      record.push(format);
+      (record.push(args), ...);
+    });
+  }
+
+  // Used by LOGGER_THREAD_KV: a message followed by key/value pairs kept as typed values.
+  // Text sinks write "message key=value ...", LoggerJsonSink one JSON object per record.
+  template <typename... Fields>
+  void logFields(
+      LogLevel level, const LoggerCallSite &site, LogLiteral message, const Fields &...fields) {
+    static_assert(sizeof...(Fields) % 2 == 0, "LOGGER_THREAD_KV takes key/value pairs");
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+    enqueue(level, [&](LogRecord &record) {
+      record.begin(level, site, clock.now());
+      record.push(message);
+      if constexpr (sizeof...(Fields) > 0) {
+        record.pushFields(fields...);
+      }
+    });
+  }
+
+  // Used by LOGGER_TRACE_SCOPE when the scope ends, startTicks comes from TraceTicks.
+  // Spans only reach sinks accepting them, such as LoggerTraceSink.
+  void traceSpan(const LoggerCallSite &site, LogLiteral name, std::uint64_t startTicks) {
+    enqueue(LogLevel::INFO, [&](LogRecord &record) {
+      record.begin(LogLevel::INFO, site, clock.now());
+      record.span = true;
+      record.push(name);
+      record.push(startTicks);
+      record.push(LoggerTraceThread::index());
+    });
+  }
+
+  std::uint64_t TraceTicks() const { return clock.now(); }
+
+  // Off by default, a LOGGER_TRACE_SCOPE then costs one relaxed load. While on the worker
+  // also records a span for every batch it writes.
+  void EnableTracing(bool enabled) { tracingEnabled.store(enabled, std::memory_order_relaxed); }
+
+  bool IsTracingEnabled() const { return tracingEnabled.load(std::memory_order_relaxed); }
+
+  // Runtime threshold, LOGGER_THREAD checks it before evaluating its arguments
+  void SetLogLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+
+  bool IsLevelEnabled(LogLevel level) const {
+    return level >= minLevel.load(std::memory_order_relaxed);
+  }
+
   void ExitLoggerThread();
 
   void StartLoggerThread(
@@ -55,54 +248,275 @@ class LoggerThread {
       const std::string &LogFolderBackupPath,
       const std::string &LogFileBackupPath);
 
+  // Same as StartLoggerThread but returns at once, the worker creates the folders and opens
+  // the log file before it writes the next record
+  void StartLoggerThreadAsync(
+      const std::string &LogFolderPath,
+      const std::string &LogFilePath,
+      const std::string &LogFolderBackupPath,
+      const std::string &LogFileBackupPath);
+
+  // Applied by the worker before its next batch, see LoggerFlushPolicy for the triggers
+  void SetFlushPolicy(const LoggerFlushPolicy &policy);
+
+  // Used for the log file opened by the next StartLoggerThread call
+  void SetRotationPolicy(const LoggerRotationPolicy &policy);
+
+  /*
+  Sinks are handed to the worker, producers never see them.
+  The console sink is attached by default and StartLoggerThread adds the log file sink.
+  Usage example (file only, warnings and above):
+  LoggerThread::GetLoggerThread().ClearSinks();
+  LoggerThread::GetLoggerThread().AddSink(
+      std::make_unique<LoggerFileSink>("game.log", true, LogLevel::WARNING));
+  */
+  LoggerSink *AddSink(std::unique_ptr<LoggerSink> sink);
+
+  // factory runs on the worker before it writes the next record, after the factories queued
+  // before it, so a sink can be opened in a folder StartLoggerThreadAsync creates
+  void AddSinkAsync(std::function<std::unique_ptr<LoggerSink>()> factory);
+
+  void ClearSinks();
+
+  /*
+  Flight recorder mode: every other sink is removed and the last capacity lines are only kept
+  in memory. They are written to dumpPath when an ERRORING or LOGICERROR record arrives, when
+  DumpFlightRecorder is called, and on SIGSEGV/SIGABRT when installCrashHandler is set.
+  */
+  void EnableFlightRecorder(
+      const std::string &dumpPath, std::size_t capacity = 4096, bool installCrashHandler = true);
+
+  // Asks the worker to dump every sink keeping records in memory
+  void DumpFlightRecorder() {
+    dumpRequested.store(true, std::memory_order_relaxed);
+    wakeWorker();
+  }
+
+  // Threads that already logged in PER_THREAD mode keep their ring, the worker drains both
+  void SetQueueMode(
+      LoggerQueueMode mode, std::size_t capacity = DefaultThreadQueueCapacity);
+
+  // keepLevel is only used by DROP_BELOW_LEVEL
+  void SetOverflowPolicy(LoggerOverflowPolicy policy, LogLevel keepLevel = LogLevel::WARNING) {
+    overflowLevel.store(keepLevel, std::memory_order_relaxed);
+    overflowPolicy.store(policy, std::memory_order_relaxed);
+  }
+
+  // ExitLoggerThread and the destructor write every pending record before returning,
+  // records still queued after this long are dropped and counted in DroppedMessages
+  void SetShutdownTimeout(std::chrono::milliseconds timeout) {
+    shutdownTimeout.store(timeout.count(), std::memory_order_relaxed);
+  }
+
+  // Records lost to the overflow policy since the logger started, the worker also logs
+  // a "N messages dropped" warning at most once per DropReportInterval
+  std::uint64_t DroppedMessages() const { return droppedRecords.load(std::memory_order_relaxed); }
+
+  // Counters and latency histograms, off by default. Producers then pay one relaxed atomic
+  // add per record, the worker two clock reads per record.
+  void EnableMetrics(bool enabled) { metricsEnabled.store(enabled, std::memory_order_relaxed); }
+
+  LoggerMetricsSnapshot GetMetrics() const {
+    LoggerMetricsSnapshot snapshot = metrics.snapshot();
+    snapshot.dropped = DroppedMessages();
+    return snapshot;
+  }
+
+  // Logs a summary of GetMetrics every interval while metrics are enabled, 0 turns it off
+  void SetMetricsReportInterval(std::chrono::seconds interval) {
+    metricsReportInterval.store(interval.count(), std::memory_order_relaxed);
+  }
+
+  // Applied by the worker before its next batch
+  void SetWorkerOptions(const LoggerWorkerOptions &options);
+
+  // Consecutive records with the same call site and arguments are written once, followed by
+  // "Last message repeated N times" when a different record arrives, at most once per
+  // RepeatReportInterval during a long run, and on shutdown
+  void SetCollapseRepeats(bool enabled) {
+    collapseRepeats.store(enabled, std::memory_order_relaxed);
+  }
+
  private:
   static std::unique_ptr<LoggerThread> LoggerInstanceT;
   std::thread workerThread;
-  std::queue<std::function<void()>> tasks;
+  LoggerRingBuffer records;
   std::mutex mtx;
   std::condition_variable Unlock_Logger_Thread;
   std::atomic<bool> Done_Logger_Thread;
-  std::ofstream logFile;
+  std::atomic<LogLevel> minLevel{LogLevel::INFO};
+  std::vector<std::unique_ptr<LoggerSink>> sinks;         // Owned by the worker
+  std::vector<std::unique_ptr<LoggerSink>> pendingSinks;  // Guarded by mtx
+  std::vector<std::function<std::unique_ptr<LoggerSink>()>> pendingSinkFactories;  // Same
+  bool clearSinksRequested = false;
+  std::atomic<bool> sinkChangesPending{true};  // Set with mtx held, checked per record
+  std::atomic<bool> dumpRequested{false};
+  LoggerFlushPolicy flushPolicy;
+  bool hasFlushPolicy = false;
+  bool flushPolicyChanged = false;
+  LoggerRotationPolicy rotationPolicy;  // Guarded by mtx
   std::string logFilePath_;
   std::string LogFolderPathForTheThread;
   std::string LogFilePathForTheThread;
   std::string LogFolderBackupPathForTheThread;
   std::string LogFileBackupPathForTheThread;
-  std::string TimeStamp;
-  std::atomic<bool> useFallback;
+  const LoggerClock clock;
+  LoggerFormatter formatter;
+  static inline std::atomic<std::uint64_t> NextInstanceId{1};
+  const std::uint64_t instanceId;
+  std::atomic<bool> perThreadQueues{false};
+  std::size_t threadQueueCapacity = DefaultThreadQueueCapacity;    // Guarded by mtx
+  std::vector<std::shared_ptr<LoggerThreadBuffer>> threadBuffers;  // Guarded by mtx
+  std::atomic<std::uint64_t> threadBuffersGeneration{0};
+  std::vector<std::shared_ptr<LoggerThreadBuffer>> activeThreadBuffers;  // Owned by the worker
+  std::uint64_t activeThreadBuffersGeneration = 0;
+  std::atomic<LoggerOverflowPolicy> overflowPolicy{LoggerOverflowPolicy::BLOCK};
+  std::atomic<LogLevel> overflowLevel{LogLevel::WARNING};
+  std::atomic<std::uint64_t> droppedRecords{0};
+  std::uint64_t reportedDroppedRecords = 0;  // Owned by the worker
+  std::chrono::steady_clock::time_point lastDropReport;
+  std::atomic<std::int64_t> shutdownTimeout{DefaultShutdownTimeout.count()};
+  std::chrono::steady_clock::time_point shutdownDeadline;  // Set before Done_Logger_Thread
+  LoggerMetrics metrics;
+  std::atomic<bool> metricsEnabled{false};
+  std::atomic<std::int64_t> metricsReportInterval{0};
+  std::chrono::steady_clock::time_point lastMetricsReport;
+  std::atomic<bool> workerSleeping{false};  // Set with mtx held while the worker waits
+  // Bumped by the worker after freeing slots, BLOCK producers park on it with atomic wait
+  std::atomic<std::uint32_t> freedSlotsEpoch{0};
+  std::atomic<std::uint32_t> blockedProducers{0};
+  LoggerWorkerOptions workerOptions;        // Guarded by mtx
+  bool workerOptionsChanged = false;
+  std::uint32_t maxSpin = LoggerWorkerOptions().maxSpin;  // Owned by the worker
+  std::uint32_t spinBudget = MinSpin;
+  static constexpr std::uint32_t MinSpin = 16;
+  std::atomic<bool> collapseRepeats{false};
+  std::atomic<bool> tracingEnabled{false};
+  LogRecord lastRecord;               // Owned by the worker, valid when hasLastRecord is set
+  bool hasLastRecord = false;
+  std::uint64_t repeatedRecords = 0;  // Copies of lastRecord not written yet
+  std::chrono::steady_clock::time_point lastRepeatReport;
+
+  template <typename Fill>
+  void enqueue(LogLevel level, Fill &&fill) {
+    // A full ring means the worker is behind, the overflow policy decides who loses
+    if (perThreadQueues.load(std::memory_order_relaxed)) {
+      LoggerSpscRingBuffer &ring = threadBuffer().ring;
+      for (int attempt = 0; !ring.tryPush(fill); ++attempt) {
+        if (!handleFullQueue(level, false, attempt)) {
+          return;
+        }
+      }
+    } else {
+      for (int attempt = 0; !records.tryPush(fill); ++attempt) {
+        if (!handleFullQueue(level, true, attempt)) {
+          return;
+        }
+      }
+    }
+    if (metricsEnabled.load(std::memory_order_relaxed)) {
+      metrics.countEnqueued(level);
+    }
+    wakeWorker();
+  }
 
-  void logWorker();
+  // Producers only pay for the futex when the worker is parked. The fence pairs with the one
+  // the worker runs between setting workerSleeping and its last look at the queues, so either
+  // the producer sees the flag or the worker sees the record.
+  void wakeWorker() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workerSleeping.load(std::memory_order_relaxed)) {
+      // Taking mtx waits until the worker is really inside wait, the notify cannot get lost
+      { std::unique_lock<std::mutex> lock(mtx); }
+      Unlock_Logger_Thread.notify_one();
+    }
+  }
 
-  std::string formatMessage(
-      LogLevel level, const std::string &sourceFile, int line, const std::string &message);
+  static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+  }
 
-  template <typename... Args>
-  void logMessage(LogLevel level, const std::string &sourceFile, int line, const Args &...args);
+  // Returns false when the new record has to be dropped
+  bool handleFullQueue(LogLevel level, bool sharedQueue, int attempt);
+  void waitForFreeSlots(bool sharedQueue);
+  void releaseBlockedProducers();
 
-  void logMessageFallback(
-      LogLevel level,
-      const std::string &sourceFile,
-      int line,
-      const std::initializer_list<std::string> &messageParts);
+  void reportDroppedRecords(bool force);
+
+  bool shutdownDeadlinePassed() const {
+    return Done_Logger_Thread.load() && std::chrono::steady_clock::now() >= shutdownDeadline;
+  }
+
+  std::size_t discardPendingRecords();
+
+  std::size_t queueDepth() const;
+
+  void reportMetrics();
+
+  bool collapseRepeat(const LogRecord &record);
+
+  void reportRepeatedRecords(bool force);
+
+  LoggerThreadBuffer &threadBuffer() {
+    static thread_local LoggerThreadBufferCache cache;
+    for (auto &entry : cache.entries) {
+      if (entry.first == instanceId) {
+        return *entry.second;
+      }
+    }
+    return registerThreadBuffer(cache);
+  }
+
+  LoggerThreadBuffer &registerThreadBuffer(LoggerThreadBufferCache &cache);
+
+  std::size_t drainThreadBuffers();
+
+  bool hasPendingRecords();
+
+  bool hasWork() {
+    return hasPendingRecords() || Done_Logger_Thread || dumpRequested.load() ||
+           sinkChangesPending.load();
+  }
+
+  void setLogFilePaths(
+      const std::string &LogFolderPath,
+      const std::string &LogFilePath,
+      const std::string &LogFolderBackupPath,
+      const std::string &LogFileBackupPath);
+
+  std::function<std::unique_ptr<LoggerSink>()> logFileSinkFactory();
+
+  bool spinForWork();
+
+  void applyWorkerOptions();
 
-  std::string extractRelativePath(const std::string &filePath);
+  void logWorker();
+
+  void applyPendingSinkChanges();
 
-  template <typename T>
-  void append(std::ostringstream &oss, const T &arg);
+  void flushSinksIfDue(bool queueEmpty);
+  void flushSinks();
+  void recordSinkFlush(std::uint64_t startTicks);
 
-  template <typename T, typename... Args>
-  void append(std::ostringstream &oss, const T &first, const Args &...args);
+  void logMessage(const LogRecord &record);
 
-  void copyFile(const std::string &source, const std::string &dest);
+  void writeRecord(const LogRecord &record);
 
-  std::string getTimestamp();
+  void traceWorkerBatch(std::uint64_t startTicks, std::size_t written);
 
-  void cleanup();
+  void cleanup(bool archiveSinks = false);
 
 #else
  public:
   LoggerThread() {}
 
+  explicit LoggerThread(
+      LoggerClockSource clockSource, std::size_t queueCapacity = DefaultQueueCapacity) {}
+
   ~LoggerThread() {}
 
   void logMessageAsync(
@@ -114,6 +528,39 @@ class LoggerThread {
       int line,
       const std::initializer_list<std::string> &messageParts) {}
 
+  template <typename... Args>
+  void logAsync(LogLevel level, std::string_view sourceFile, int line, const Args &...args) {}
+
+  template <typename... Args>
+  void logAsync(LogLevel level, const LoggerCallSite &site, const Args &...args) {}
+
+  template <typename... Args>
+  void logCategory(
+      LogLevel level, const LoggerCallSite &site, std::uint16_t category, const Args &...args) {}
+
+  template <typename... Args>
+  void logFormat(
+      LogLevel level,
+      const LoggerCallSite &site,
+      LoggerFormatString<Args...> format,
+      const Args &...args) {}
+
+  template <typename... Fields>
+  void logFields(
+      LogLevel level, const LoggerCallSite &site, LogLiteral message, const Fields &...fields) {}
+
+  void traceSpan(const LoggerCallSite &site, LogLiteral name, std::uint64_t startTicks) {}
+
+  std::uint64_t TraceTicks() const { return 0; }
+
+  void EnableTracing(bool enabled) {}
+
+  bool IsTracingEnabled() const { return false; }
+
+  void SetLogLevel(LogLevel level) {}
+
+  bool IsLevelEnabled(LogLevel level) const { return false; }
+
   void ExitLoggerThread() {}
 
   void StartLoggerThread(
@@ -122,26 +569,177 @@ class LoggerThread {
       const std::string &LogFolderBackupPath,
       const std::string &LogFileBackupPath) {}
 
+  void StartLoggerThreadAsync(
+      const std::string &LogFolderPath,
+      const std::string &LogFilePath,
+      const std::string &LogFolderBackupPath,
+      const std::string &LogFileBackupPath) {}
+
+  void SetFlushPolicy(const LoggerFlushPolicy &policy) {}
+
+  void SetRotationPolicy(const LoggerRotationPolicy &policy) {}
+
+  LoggerSink *AddSink(std::unique_ptr<LoggerSink> sink) { return nullptr; }
+
+  void AddSinkAsync(std::function<std::unique_ptr<LoggerSink>()> factory) {}
+
+  void ClearSinks() {}
+
+  void EnableFlightRecorder(
+      const std::string &dumpPath, std::size_t capacity = 4096, bool installCrashHandler = true) {}
+
+  void DumpFlightRecorder() {}
+
+  void SetQueueMode(
+      LoggerQueueMode mode, std::size_t capacity = DefaultThreadQueueCapacity) {}
+
+  void SetOverflowPolicy(LoggerOverflowPolicy policy, LogLevel keepLevel = LogLevel::WARNING) {}
+
+  void SetShutdownTimeout(std::chrono::milliseconds timeout) {}
+
+  std::uint64_t DroppedMessages() const { return 0; }
+
+  void EnableMetrics(bool enabled) {}
+
+  LoggerMetricsSnapshot GetMetrics() const { return {}; }
+
+  void SetMetricsReportInterval(std::chrono::seconds interval) {}
+
+  void SetWorkerOptions(const LoggerWorkerOptions &options) {}
+
+  void SetCollapseRepeats(bool enabled) {}
+
  private:
   void logWorker() {}
 
-  template <typename... Args>
-  void logMessage(LogLevel level, const std::string &sourceFile, int line, const Args &...args) {}
+  void logMessage(const LogRecord &record) {}
+#endif
+};
 
-  template <typename T>
-  void append(std::ostringstream &oss, const T &arg) {}
+// RAII span of LOGGER_TRACE_SCOPE, nothing is recorded when tracing was off at construction
+class LoggerTraceScope {
+ public:
+  LoggerTraceScope(LoggerThread &loggerThread, const LoggerCallSite &callSite, LogLiteral spanName)
+      : logger(loggerThread.IsTracingEnabled() ? &loggerThread : nullptr),
+        site(callSite),
+        name(spanName),
+        startTicks(logger != nullptr ? loggerThread.TraceTicks() : 0) {}
+
+  ~LoggerTraceScope() {
+    if (logger != nullptr) {
+      logger->traceSpan(site, name, startTicks);
+    }
+  }
 
-  template <typename T, typename... Args>
-  void append(std::ostringstream &oss, const T &first, const Args &...args) {}
+  LoggerTraceScope(const LoggerTraceScope &) = delete;
+  LoggerTraceScope &operator=(const LoggerTraceScope &) = delete;
 
-  void copyFile(const std::string &source, const std::string &dest) {}
-#endif
+ private:
+  LoggerThread *logger;
+  const LoggerCallSite &site;
+  LogLiteral name;
+  std::uint64_t startTicks;
 };
+
+// Named output of a LoggerCategoryPool, records go to the worker owning its sinks
+struct LoggerCategory {
+  std::string name;
+  std::uint16_t id;
+  LoggerThread *logger;
+};
+
+#define LOGGER_THREAD_CONCAT_INNER(a, b) a##b
+#define LOGGER_THREAD_CONCAT(a, b) LOGGER_THREAD_CONCAT_INNER(a, b)
 #if defined(_WIN32) || defined(__linux__) || !defined(__ANDROID__) || !defined(EMSCRIPTEN) || \
     !defined(__NINTENDO__) || !defined(TARGET_OS_IPHONE)
-#define LOGGER_THREAD(loglevel, customString) \
-  LoggerThread::GetLoggerThread().logMessageAsync(loglevel, __FILE__, __LINE__, customString);
+// Logs only when condition holds, condition is checked after the level and before the
+// arguments are evaluated
+#define LOGGER_THREAD_IF(condition, loglevel, ...)                                           \
+  do {                                                                                       \
+    if (static_cast<int>(loglevel) >= LOGGER_THREAD_MIN_LEVEL) {                             \
+      LoggerThread &loggerThreadInstance = LoggerThread::GetLoggerThread();                  \
+      if (loggerThreadInstance.IsLevelEnabled(loglevel) && (condition)) {                    \
+        static constinit LoggerCallSite loggerThreadCallSite(__FILE__, __LINE__);            \
+        loggerThreadInstance.logAsync(loglevel, loggerThreadCallSite, __VA_ARGS__);          \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0);
+#define LOGGER_THREAD(loglevel, ...) LOGGER_THREAD_IF(true, loglevel, __VA_ARGS__)
+// std::format style pattern checked at compile time, formatted by the worker
+#define LOGGER_THREAD_FORMAT(loglevel, format, ...)                                          \
+  do {                                                                                       \
+    if (static_cast<int>(loglevel) >= LOGGER_THREAD_MIN_LEVEL) {                             \
+      LoggerThread &loggerThreadInstance = LoggerThread::GetLoggerThread();                  \
+      if (loggerThreadInstance.IsLevelEnabled(loglevel)) {                                   \
+        static constinit LoggerCallSite loggerThreadCallSite(__FILE__, __LINE__);            \
+        loggerThreadInstance.logFormat(                                                      \
+            loglevel, loggerThreadCallSite, format __VA_OPT__(, ) __VA_ARGS__);              \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0);
+// Structured record, message must be a string literal:
+//   LOGGER_THREAD_KV(LogLevel::INFO, "frame", "ms", frameTime, "draws", drawCount)
+#define LOGGER_THREAD_KV(loglevel, message, ...)                                             \
+  do {                                                                                       \
+    if (static_cast<int>(loglevel) >= LOGGER_THREAD_MIN_LEVEL) {                             \
+      LoggerThread &loggerThreadInstance = LoggerThread::GetLoggerThread();                  \
+      if (loggerThreadInstance.IsLevelEnabled(loglevel)) {                                   \
+        static constinit LoggerCallSite loggerThreadCallSite(__FILE__, __LINE__);            \
+        loggerThreadInstance.logFields(                                                      \
+            loglevel, loggerThreadCallSite, message __VA_OPT__(, ) __VA_ARGS__);             \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0);
+// For lines hit every frame: the first call and every nth one after it
+#define LOGGER_THREAD_EVERY_N(n, loglevel, ...)                                              \
+  do {                                                                                       \
+    static constinit LoggerEveryN loggerThreadEveryN;                                        \
+    LOGGER_THREAD_IF(loggerThreadEveryN.allow(n), loglevel, __VA_ARGS__)                     \
+  } while (0);
+#define LOGGER_THREAD_ONCE(loglevel, ...)                                                    \
+  do {                                                                                       \
+    static constinit LoggerOnce loggerThreadOnce;                                            \
+    LOGGER_THREAD_IF(loggerThreadOnce.allow(), loglevel, __VA_ARGS__)                        \
+  } while (0);
+// At most perSecond calls per second on average, see LoggerRateLimiter
+#define LOGGER_THREAD_RATE(perSecond, loglevel, ...)                                         \
+  do {                                                                                       \
+    static constinit LoggerRateLimiter loggerThreadRate;                                     \
+    LOGGER_THREAD_IF(loggerThreadRate.allow(perSecond), loglevel, __VA_ARGS__)               \
+  } while (0);
+// Same as LOGGER_THREAD for a LoggerCategory, order is kept within the category:
+//   LOGGER_THREAD_CATEGORY(renderLog, LogLevel::WARNING, "Swap chain out of date")
+#define LOGGER_THREAD_CATEGORY(category, loglevel, ...)                                      \
+  do {                                                                                       \
+    if (static_cast<int>(loglevel) >= LOGGER_THREAD_MIN_LEVEL) {                             \
+      const LoggerCategory &loggerThreadCategory = (category);                               \
+      if (loggerThreadCategory.logger->IsLevelEnabled(loglevel)) {                           \
+        static constinit LoggerCallSite loggerThreadCallSite(__FILE__, __LINE__);            \
+        loggerThreadCategory.logger->logCategory(                                            \
+            loglevel, loggerThreadCallSite, loggerThreadCategory.id, __VA_ARGS__);           \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0);
+#if LOGGER_THREAD_TRACING
+// Records the time until the end of the enclosing scope, name must be a string literal:
+//   LOGGER_TRACE_SCOPE("draw shadows");
+#define LOGGER_TRACE_SCOPE(name)                                                             \
+  static constinit LoggerCallSite LOGGER_THREAD_CONCAT(loggerTraceCallSite, __LINE__)(      \
+      __FILE__, __LINE__);                                                                   \
+  LoggerTraceScope LOGGER_THREAD_CONCAT(loggerTraceScope, __LINE__)(                         \
+      LoggerThread::GetLoggerThread(), LOGGER_THREAD_CONCAT(loggerTraceCallSite, __LINE__), name)
+#else
+#define LOGGER_TRACE_SCOPE(name)
+#endif
 #else
-#define LOGGER_THREAD(loglevel, customString)
+#define LOGGER_THREAD_IF(condition, loglevel, ...)
+#define LOGGER_THREAD(loglevel, ...)
+#define LOGGER_THREAD_FORMAT(loglevel, format, ...)
+#define LOGGER_THREAD_KV(loglevel, message, ...)
+#define LOGGER_THREAD_CATEGORY(category, loglevel, ...)
+#define LOGGER_THREAD_EVERY_N(n, loglevel, ...)
+#define LOGGER_THREAD_ONCE(loglevel, ...)
+#define LOGGER_THREAD_RATE(perSecond, loglevel, ...)
+#define LOGGER_TRACE_SCOPE(name)
 #endif
 #endif  // LOGGER_THREAD_HPP
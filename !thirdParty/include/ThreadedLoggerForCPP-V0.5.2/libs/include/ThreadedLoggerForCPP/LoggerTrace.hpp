@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "LoggerArgs.hpp"
+#include "LoggerFileWriter.hpp"
+#include "LoggerFormatter.hpp"
+#include "LoggerRecord.hpp"
+#include "LoggerSink.hpp"
+
+// Small number naming the calling thread in traces, given out on first use
+struct LoggerTraceThread {
+  static std::uint64_t index() {
+    static std::atomic<std::uint64_t> next{1};
+    thread_local std::uint64_t current = next.fetch_add(1, std::memory_order_relaxed);
+    return current;
+  }
+};
+
+// Writes LOGGER_TRACE_SCOPE spans in the Chrome trace event format, open the file in
+// chrome://tracing or ui.perfetto.dev:
+//   [
+//   {"name":"frame","cat":"scope","ph":"X","ts":1234.567,"dur":16.002,"pid":1,"tid":2,
+//    "args":{"file":"src/first_app.cpp","line":12}},
+//   {"name":"Swap chain out of date","cat":"log","ph":"i","s":"g","ts":1250.000,...}
+//   ]
+// Spans are complete events, records at level and above become instant events on the same
+// timeline. Times are microseconds since the sink was created. The closing bracket is
+// written on destruction, the viewers also load a file cut short by a crash.
+class LoggerTraceSink : public LoggerSink {
+ public:
+  explicit LoggerTraceSink(const std::string &path, LogLevel level = LogLevel::WARNING)
+      : LoggerSink(level),
+        origin(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count()) {
+    if (writer.open(path, true)) {
+      writer.write("[\n", LogLevel::INFO);
+    }
+  }
+
+  ~LoggerTraceSink() override {
+    if (writer.isOpen()) {
+      writer.write("\n]\n", LogLevel::INFO);
+    }
+  }
+
+  bool isOpen() const { return writer.isOpen(); }
+
+  bool acceptsSpans() const override { return true; }
+
+  void write(LoggerFormatter &formatter) override {
+    const LogRecord &record = formatter.record();
+    event.clear();
+    if (!empty) {
+      event.append(",\n");
+    }
+    if (record.span) {
+      if (!appendSpan(formatter)) {
+        return;
+      }
+    } else {
+      event.append("{\"name\":");
+      LoggerJsonSink::appendEscaped(event, formatter.message());
+      event.append(",\"cat\":\"log\",\"ph\":\"i\",\"s\":\"g\",\"ts\":");
+      appendMicroseconds(formatter.systemNanoseconds() - origin);
+      event.append(",\"pid\":1,\"tid\":0,\"args\":{\"level\":\"");
+      event.append(LoggerJsonSink::levelName(record.level));
+      event.append("\",");
+      appendSource(formatter);
+      event.append("}}");
+    }
+    empty = false;
+    writer.write(event, record.level);
+  }
+
+  void setFlushPolicy(const LoggerFlushPolicy &policy) override { writer.setPolicy(policy); }
+
+  void flushIfDue(bool queueEmpty) override { writer.flushIfDue(queueEmpty); }
+
+  void flush() override { writer.flush(); }
+
+ private:
+  // The record holds the name literal, the start ticks and the thread index, its
+  // timestamp is the end of the span
+  bool appendSpan(LoggerFormatter &formatter) {
+    std::string_view args = formatter.record().args();
+    const char *it = args.data();
+    if (args.size() < 3 + sizeof(const char *) + 2 * sizeof(std::uint64_t) ||
+        static_cast<LogArgType>(*it++) != LogArgType::LITERAL) {
+      return false;
+    }
+    const char *name = LoggerArgs::read<const char *>(it);
+    if (static_cast<LogArgType>(*it++) != LogArgType::UINT) {
+      return false;
+    }
+    std::uint64_t startTicks = LoggerArgs::read<std::uint64_t>(it);
+    if (static_cast<LogArgType>(*it++) != LogArgType::UINT) {
+      return false;
+    }
+    std::uint64_t thread = LoggerArgs::read<std::uint64_t>(it);
+
+    std::int64_t start = formatter.systemNanoseconds(startTicks);
+    event.append("{\"name\":");
+    LoggerJsonSink::appendEscaped(event, name);
+    event.append(",\"cat\":\"scope\",\"ph\":\"X\",\"ts\":");
+    appendMicroseconds(start - origin);
+    event.append(",\"dur\":");
+    appendMicroseconds(std::max<std::int64_t>(formatter.systemNanoseconds() - start, 0));
+    event.append(",\"pid\":1,\"tid\":");
+    appendNumber(thread);
+    event.append(",\"args\":{");
+    appendSource(formatter);
+    event.append("}}");
+    return true;
+  }
+
+  void appendSource(LoggerFormatter &formatter) {
+    event.append("\"file\":");
+    LoggerJsonSink::appendEscaped(event, formatter.relativePath());
+    event.append(",\"line\":");
+    appendNumber(formatter.record().line);
+  }
+
+  // Fixed point with three decimals, a double would lose the nanoseconds on long sessions
+  void appendMicroseconds(std::int64_t nanoseconds) {
+    if (nanoseconds < 0) {
+      event.push_back('-');
+      nanoseconds = -nanoseconds;
+    }
+    appendNumber(nanoseconds / 1000);
+    char fraction[4] = {'.', '0', '0', '0'};
+    auto rest = static_cast<int>(nanoseconds % 1000);
+    for (int i = 3; i > 0; --i, rest /= 10) {
+      fraction[i] = static_cast<char>('0' + rest % 10);
+    }
+    event.append(fraction, sizeof(fraction));
+  }
+
+  template <typename T>
+  void appendNumber(T value) {
+    char number[32];
+    auto result = std::to_chars(number, number + sizeof(number), value);
+    event.append(number, result.ptr);
+  }
+
+  const std::int64_t origin;  // System nanoseconds at ts 0
+  bool empty = true;
+  LoggerFileWriter writer;
+  std::string event;
+};
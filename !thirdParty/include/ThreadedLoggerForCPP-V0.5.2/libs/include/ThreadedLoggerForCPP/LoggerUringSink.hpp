@@ -0,0 +1,433 @@
+#pragma once
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define LOGGER_THREAD_HAS_IO_URING 1
+#else
+#define LOGGER_THREAD_HAS_IO_URING 0
+#endif
+
+#include "LoggerFileWriter.hpp"
+#include "LoggerFormatter.hpp"
+#include "LoggerSink.hpp"
+
+#if LOGGER_THREAD_HAS_IO_URING
+// Bare io_uring through the raw system calls, just what LoggerUringFileSink needs: one
+// submission at a time and blocking or polling reaps. init fails on kernels older than 5.1
+// and where seccomp blocks io_uring (containers, some distributions).
+class LoggerUring {
+ public:
+  LoggerUring() = default;
+
+  ~LoggerUring() {
+    if (sqRing != nullptr) {
+      munmap(sqRing, sqRingBytes);
+    }
+    if (cqRing != nullptr && cqRing != sqRing) {
+      munmap(cqRing, cqRingBytes);
+    }
+    if (sqes != nullptr) {
+      munmap(sqes, sqesBytes);
+    }
+    if (ringFd >= 0) {
+      close(ringFd);
+    }
+  }
+
+  LoggerUring(const LoggerUring &) = delete;
+  LoggerUring &operator=(const LoggerUring &) = delete;
+
+  // Fault injection for tests: submissions fail with EAGAIN while it returns true
+  static inline bool (*submitFault)() = nullptr;
+
+  bool init(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0) {
+      return false;
+    }
+    sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+      sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+    }
+    sqRing = mapRing(sqRingBytes, IORING_OFF_SQ_RING);
+    cqRing = singleMmap ? sqRing : mapRing(cqRingBytes, IORING_OFF_CQ_RING);
+    sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(mapRing(sqesBytes, IORING_OFF_SQES));
+    if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr) {
+      return false;
+    }
+    char *sq = static_cast<char *>(sqRing);
+    char *cq = static_cast<char *>(cqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  // Pins the buffers so writes skip the page lookups, fails when RLIMIT_MEMLOCK is too low
+  bool registerBuffers(const iovec *buffers, unsigned count) {
+    return syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+  }
+
+  // bufferIndex < 0 writes from an unregistered buffer
+  bool submitWrite(
+      int fd,
+      const char *data,
+      unsigned size,
+      std::uint64_t offset,
+      int bufferIndex,
+      std::uint64_t userData) {
+    unsigned tail = *sqTail;
+    if (tail - std::atomic_ref<unsigned>(*sqHead).load(std::memory_order_acquire) > sqMask) {
+      return false;  // Full, the sink never has more writes in flight than buffers
+    }
+    unsigned index = tail & sqMask;
+    io_uring_sqe &sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = bufferIndex >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(data);
+    sqe.len = size;
+    sqe.off = offset;
+    sqe.buf_index = static_cast<std::uint16_t>(std::max(bufferIndex, 0));
+    sqe.user_data = userData;
+    sqArray[index] = index;
+    std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+    if (enter(1, 0, 0) == 1 ||
+        std::atomic_ref<unsigned>(*sqHead).load(std::memory_order_acquire) != tail) {
+      return true;  // Consumed by the kernel, a completion will follow
+    }
+    // Not consumed (EAGAIN, EBUSY, ENOMEM...): withdraw the entry, otherwise the next enter
+    // would submit it with a buffer that has been refilled since
+    std::atomic_ref<unsigned>(*sqTail).store(tail, std::memory_order_release);
+    return false;
+  }
+
+  // Takes one completion, waiting for it when wait is set. False when none is ready.
+  bool reap(bool wait, std::uint64_t &userData, int &result) {
+    while (true) {
+      unsigned head = *cqHead;
+      if (head != std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire)) {
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        userData = cqe.user_data;
+        result = cqe.res;
+        std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+        return true;
+      }
+      if (!wait || enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+        return false;
+      }
+    }
+  }
+
+ private:
+  void *mapRing(std::size_t bytes, std::uint64_t offset) {
+    void *ring = mmap(
+        nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+        static_cast<off_t>(offset));
+    return ring == MAP_FAILED ? nullptr : ring;
+  }
+
+  int enter(unsigned submit, unsigned waitFor, unsigned flags) {
+    if (submit > 0 && submitFault != nullptr && submitFault()) {
+      errno = EAGAIN;
+      return -1;
+    }
+    while (true) {
+      int result = static_cast<int>(
+          syscall(__NR_io_uring_enter, ringFd, submit, waitFor, flags, nullptr, 0));
+      if (result >= 0 || errno != EINTR) {
+        return result;
+      }
+    }
+  }
+
+  int ringFd = -1;
+  void *sqRing = nullptr;
+  void *cqRing = nullptr;
+  io_uring_sqe *sqes = nullptr;
+  std::size_t sqRingBytes = 0;
+  std::size_t cqRingBytes = 0;
+  std::size_t sqesBytes = 0;
+  unsigned *sqHead = nullptr;
+  unsigned *sqTail = nullptr;
+  unsigned *sqArray = nullptr;
+  unsigned sqMask = 0;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned cqMask = 0;
+  io_uring_cqe *cqes = nullptr;
+};
+#endif
+
+/*
+Text file sink that does not wait for the disk. Lines are formatted into one of two buffers
+while the other one is being written through io_uring, so the worker only blocks when both
+are full or when a flush has to reach the kernel (flush, flushLevel records, shutdown).
+The buffers are registered with the ring when RLIMIT_MEMLOCK allows it. Without io_uring
+(other systems, old kernels, seccomp) every buffer is written with a blocking pwrite.
+Usage example:
+  LoggerThread::GetLoggerThread().AddSink(
+      std::make_unique<LoggerUringFileSink>("game.log", true));
+*/
+class LoggerUringFileSink : public LoggerSink {
+ public:
+  static constexpr std::size_t DefaultBufferBytes = 256 * 1024;
+
+  LoggerUringFileSink(
+      const std::string &path,
+      bool truncate,
+      LogLevel level = LogLevel::INFO,
+      std::size_t bufferBytes = DefaultBufferBytes)
+      : LoggerSink(level), capacity(std::max<std::size_t>(bufferBytes, 4096)) {
+#ifdef _WIN32
+    int flags = _O_WRONLY | _O_CREAT | _O_BINARY | _O_NOINHERIT;
+    fd = _open(path.c_str(), flags | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+    if (fd >= 0 && !truncate) {
+      fileOffset = static_cast<std::uint64_t>(std::max<__int64>(_lseeki64(fd, 0, SEEK_END), 0));
+    }
+#else
+    // No O_APPEND, every write carries its own offset so two writes can be in flight
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    fd = ::open(path.c_str(), flags | (truncate ? O_TRUNC : 0), 0644);
+    if (fd >= 0 && !truncate) {
+      fileOffset = static_cast<std::uint64_t>(std::max<off_t>(::lseek(fd, 0, SEEK_END), 0));
+    }
+#endif
+    for (auto &buffer : buffers) {
+      buffer.data = std::make_unique<char[]>(capacity);
+    }
+#if LOGGER_THREAD_HAS_IO_URING
+    if (fd >= 0 && ring.init(4)) {
+      uring = true;
+      iovec registered[BufferCount];
+      for (std::size_t i = 0; i < BufferCount; ++i) {
+        registered[i].iov_base = buffers[i].data.get();
+        registered[i].iov_len = capacity;
+      }
+      fixedBuffers = ring.registerBuffers(registered, BufferCount);
+    }
+#endif
+  }
+
+  ~LoggerUringFileSink() override {
+    flush();
+    if (fd >= 0) {
+#ifdef _WIN32
+      _close(fd);
+#else
+      ::close(fd);
+#endif
+    }
+  }
+
+  bool isOpen() const { return fd >= 0; }
+
+  // False when writes fall back to pwrite
+  bool usesUring() const { return uring; }
+
+  void write(LoggerFormatter &formatter) override {
+    std::string_view line = formatter.text();
+    LogLevel level = formatter.record().level;
+    if (line.size() + 1 > capacity - buffers[active].size) {
+      submitActive();
+    }
+    Buffer &buffer = buffers[active];
+    if (line.size() + 1 > capacity) {
+      // Longer than a whole buffer, written on its own at the offset it belongs to
+      writeBlocking(line.data(), line.size(), fileOffset);
+      writeBlocking("\n", 1, fileOffset + line.size());
+      fileOffset += line.size() + 1;
+    } else {
+      if (buffer.size == 0) {
+        oldestPending = std::chrono::steady_clock::now();
+      }
+      std::memcpy(buffer.data.get() + buffer.size, line.data(), line.size());
+      buffer.data[buffer.size + line.size()] = '\n';
+      buffer.size += line.size() + 1;
+    }
+    if (level >= policy.flushLevel) {
+      flush();
+    } else if (buffers[active].size >= std::min(policy.maxBufferedBytes, capacity)) {
+      submitActive();
+    }
+  }
+
+  void setFlushPolicy(const LoggerFlushPolicy &flushPolicy) override { policy = flushPolicy; }
+
+  // Submits without waiting, the worker can go idle while the kernel writes
+  void flushIfDue(bool queueEmpty) override {
+    reapCompleted(false);
+    if (buffers[active].size == 0) {
+      return;
+    }
+    if ((queueEmpty && policy.flushWhenIdle) ||
+        std::chrono::steady_clock::now() - oldestPending >= policy.maxInterval) {
+      submitActive();
+    }
+  }
+
+  // Returns once every buffered line has been handed to the kernel
+  void flush() override {
+    submitActive();
+    for (std::size_t i = 0; i < BufferCount; ++i) {
+      waitFor(i);
+    }
+  }
+
+ private:
+  static constexpr std::size_t BufferCount = 2;
+
+  struct Buffer {
+    std::unique_ptr<char[]> data;
+    std::size_t size = 0;
+    std::uint64_t offset = 0;  // Where the in flight write goes
+    bool inFlight = false;
+  };
+
+  // Hands the active buffer to the kernel and switches to the other one, waiting for
+  // the write still in flight from it
+  void submitActive() {
+    Buffer &buffer = buffers[active];
+    if (buffer.size == 0 || fd < 0) {
+      buffer.size = 0;
+      return;
+    }
+    buffer.offset = fileOffset;
+    fileOffset += buffer.size;
+#if LOGGER_THREAD_HAS_IO_URING
+    if (uring &&
+        ring.submitWrite(
+            fd, buffer.data.get(), static_cast<unsigned>(buffer.size), buffer.offset,
+            fixedBuffers ? static_cast<int>(active) : -1, active)) {
+      buffer.inFlight = true;
+    } else
+#endif
+    {
+      writeBlocking(buffer.data.get(), buffer.size, buffer.offset);
+      buffer.size = 0;
+    }
+    active = (active + 1) % BufferCount;
+    waitFor(active);
+  }
+
+  void waitFor(std::size_t index) {
+    while (buffers[index].inFlight) {
+      if (!reapCompleted(true)) {
+        abandonRing();
+      }
+    }
+  }
+
+  // The ring stopped delivering completions while the kernel may still read from the
+  // buffers in flight. Their bytes are written again at the same offsets with pwrite, the
+  // buffers are retired without being touched again, later writes get fresh buffers and
+  // go through pwrite.
+  void abandonRing() {
+    uring = false;
+    for (auto &buffer : buffers) {
+      if (!buffer.inFlight) {
+        continue;
+      }
+      writeBlocking(buffer.data.get(), buffer.size, buffer.offset);
+      retiredBuffers.push_back(std::move(buffer.data));
+      buffer.data = std::make_unique<char[]>(capacity);
+      buffer.size = 0;
+      buffer.inFlight = false;
+    }
+  }
+
+  // Returns false when nothing could be reaped
+  bool reapCompleted(bool wait) {
+#if LOGGER_THREAD_HAS_IO_URING
+    bool reaped = false;
+    std::uint64_t index = 0;
+    int result = 0;
+    while (uring && ring.reap(wait && !reaped, index, result)) {
+      reaped = true;
+      if (index >= BufferCount) {
+        continue;
+      }
+      Buffer &buffer = buffers[index];
+      // A short or failed write finishes with a blocking one, offsets keep the order
+      std::size_t written = result > 0 ? static_cast<std::size_t>(result) : 0;
+      if (written < buffer.size) {
+        writeBlocking(
+            buffer.data.get() + written, buffer.size - written, buffer.offset + written);
+      }
+      buffer.size = 0;
+      buffer.inFlight = false;
+    }
+    return reaped;
+#else
+    (void)wait;
+    return false;
+#endif
+  }
+
+  void writeBlocking(const char *data, std::size_t size, std::uint64_t offset) {
+    while (size > 0 && fd >= 0) {
+#ifdef _WIN32
+      _lseeki64(fd, static_cast<__int64>(offset), SEEK_SET);
+      int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+      ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+#endif
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return;  // Nothing sensible to report to, drop the rest
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+      offset += static_cast<std::uint64_t>(written);
+    }
+  }
+
+  const std::size_t capacity;
+  Buffer buffers[BufferCount];
+  std::size_t active = 0;
+  int fd = -1;
+  std::uint64_t fileOffset = 0;  // End of the file once every submitted write is done
+  LoggerFlushPolicy policy;
+  std::chrono::steady_clock::time_point oldestPending;
+  bool uring = false;
+  bool fixedBuffers = false;
+  std::vector<std::unique_ptr<char[]>> retiredBuffers;  // Freed once the ring is closed
+#if LOGGER_THREAD_HAS_IO_URING
+  LoggerUring ring;
+#endif
+};
@@ -1,4 +1,14 @@
 #include "../libs/include/ThreadedLoggerForCPP/LoggerThread.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 std::unique_ptr<LoggerThread> LoggerThread::LoggerInstanceT;
 
 void LoggerThread::SetLoggerThread(std::unique_ptr<LoggerThread> newLoggerInstance) {
@@ -22,32 +32,39 @@ void LoggerThread::logMessageAsync(
     const std::string &sourceFile,
     int line,
     const std::initializer_list<std::string> &messageParts) {
-  if (useFallback) {
-    logMessageFallback(level, sourceFile, line, messageParts);
+  if (!IsLevelEnabled(level)) {
     return;
   }
+  enqueue(level, [&](LogRecord &record) {
+    record.begin(level, sourceFile, line, clock.now());
+    for (const auto &part : messageParts) {
+      record.push(part);
+    }
+  });
+}
 
-  std::ostringstream messageStream;
-  for (const auto &part : messageParts) {
-    messageStream << part;
-  }
-  std::string message = messageStream.str();
+// The log file is renamed into the backup folder by its sink, nothing is copied
+void LoggerThread::ExitLoggerThread() { cleanup(true); }
 
-  {
-    std::unique_lock<std::mutex> lock(mtx);
-    tasks.emplace([=] { logMessage(level, sourceFile, line, message); });
-  }
-  Unlock_Logger_Thread.notify_one();
+void LoggerThread::StartLoggerThread(
+    const std::string &LogFolderPath,
+    const std::string &LogFilePath,
+    const std::string &LogFolderBackupPath,
+    const std::string &LogFileBackupPath) {
+  setLogFilePaths(LogFolderPath, LogFilePath, LogFolderBackupPath, LogFileBackupPath);
+  AddSink(logFileSinkFactory()());
 }
 
-void LoggerThread::ExitLoggerThread() {
-  cleanup();
-  TimeStamp = getTimestamp();
-  std::string src = LogFilePathForTheThread;
-  std::string dst = LogFileBackupPathForTheThread + TimeStamp + ".log";
-  copyFile(src, dst);
+void LoggerThread::StartLoggerThreadAsync(
+    const std::string &LogFolderPath,
+    const std::string &LogFilePath,
+    const std::string &LogFolderBackupPath,
+    const std::string &LogFileBackupPath) {
+  setLogFilePaths(LogFolderPath, LogFilePath, LogFolderBackupPath, LogFileBackupPath);
+  AddSinkAsync(logFileSinkFactory());
 }
-void LoggerThread::StartLoggerThread(
+
+void LoggerThread::setLogFilePaths(
     const std::string &LogFolderPath,
     const std::string &LogFilePath,
     const std::string &LogFolderBackupPath,
@@ -57,161 +74,612 @@ void LoggerThread::StartLoggerThread(
   this->logFilePath_ = LogFilePath;
   this->LogFolderBackupPathForTheThread = LogFolderBackupPath;
   this->LogFileBackupPathForTheThread = LogFileBackupPath;
-  LoggerFileSystem::createDirectories(LogFolderBackupPathForTheThread);
-  LoggerFileSystem::createDirectories(LogFolderPathForTheThread);
-  LoggerFileSystem::createFile(LogFilePathForTheThread);
-  logFile.open(logFilePath_,
-               std::ios::out | std::ios::trunc);  // Open file in truncate mode
-  if (!logFile.is_open()) {
-    std::cerr << "Error: Unable to open log file.\n";
-    useFallback = true;
+}
+
+// Creates the log folders and opens the log file, falling back to fallback_log.txt until the
+// file can be opened. Runs on the caller or, for StartLoggerThreadAsync, on the worker.
+std::function<std::unique_ptr<LoggerSink>()> LoggerThread::logFileSinkFactory() {
+  LoggerRotationPolicy policy;
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    policy = rotationPolicy;
   }
+  std::string folderPath = LogFolderPathForTheThread;
+  std::string filePath = LogFilePathForTheThread;
+  std::string backupFolderPath = LogFolderBackupPathForTheThread;
+  std::string backupPath = LogFileBackupPathForTheThread;
+  return [=]() -> std::unique_ptr<LoggerSink> {
+    LoggerFileSystem::createDirectories(folderPath);
+    LoggerFileSystem::createDirectories(backupFolderPath);
+    auto openLogFile = [filePath, backupPath, policy]() -> std::unique_ptr<LoggerSink> {
+      auto logFile = std::make_unique<LoggerRotatingFileSink>(
+          filePath, backupPath, policy, true);  // Truncate mode
+      if (!logFile->isOpen()) {
+        return nullptr;
+      }
+      return logFile;
+    };
+    std::unique_ptr<LoggerSink> logFile = openLogFile();
+    if (logFile == nullptr) {
+      std::cerr << "Error: Unable to open log file, using fallback_log.txt until it can be "
+                   "opened.\n";
+      logFile = std::make_unique<LoggerFallbackSink>("fallback_log.txt", openLogFile);
+    }
+    return logFile;
+  };
 }
 
-void LoggerThread::logWorker() {
+void LoggerThread::SetRotationPolicy(const LoggerRotationPolicy &policy) {
+  std::unique_lock<std::mutex> lock(mtx);
+  rotationPolicy = policy;
+}
+
+void LoggerThread::SetFlushPolicy(const LoggerFlushPolicy &policy) {
+  std::unique_lock<std::mutex> lock(mtx);
+  flushPolicy = policy;
+  hasFlushPolicy = true;
+  flushPolicyChanged = true;
+  sinkChangesPending.store(true, std::memory_order_release);
+}
+
+LoggerSink *LoggerThread::AddSink(std::unique_ptr<LoggerSink> sink) {
+  std::unique_lock<std::mutex> lock(mtx);
+  LoggerSink *added = sink.get();
+  pendingSinks.push_back(std::move(sink));
+  sinkChangesPending.store(true, std::memory_order_release);
+  return added;
+}
+
+void LoggerThread::AddSinkAsync(std::function<std::unique_ptr<LoggerSink>()> factory) {
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    pendingSinkFactories.push_back(std::move(factory));
+    sinkChangesPending.store(true, std::memory_order_release);
+  }
+  Unlock_Logger_Thread.notify_one();
+}
+
+void LoggerThread::ClearSinks() {
+  std::unique_lock<std::mutex> lock(mtx);
+  pendingSinks.clear();
+  pendingSinkFactories.clear();
+  clearSinksRequested = true;
+  sinkChangesPending.store(true, std::memory_order_release);
+}
+
+void LoggerThread::EnableFlightRecorder(
+    const std::string &dumpPath, std::size_t capacity, bool installCrashHandler) {
+  auto recorder = std::make_unique<LoggerFlightRecorderSink>(dumpPath, capacity);
+  if (!recorder->isOpen()) {
+    std::cerr << "Error: Unable to open flight recorder file " << dumpPath << ".\n";
+  }
+  if (installCrashHandler) {
+    recorder->installCrashHandler();
+  }
+  std::unique_lock<std::mutex> lock(mtx);
+  pendingSinks.clear();
+  pendingSinkFactories.clear();
+  clearSinksRequested = true;
+  pendingSinks.push_back(std::move(recorder));
+  sinkChangesPending.store(true, std::memory_order_release);
+}
+
+// Called by the worker with mtx held
+void LoggerThread::applyPendingSinkChanges() {
+  if (clearSinksRequested) {
+    for (auto &sink : sinks) {
+      sink->flush();
+    }
+    sinks.clear();
+    clearSinksRequested = false;
+  }
+  // Opening files here keeps producers that wait on mtx waiting, factories are meant for
+  // the sinks set up once at startup
+  for (auto &factory : pendingSinkFactories) {
+    if (auto sink = factory()) {
+      pendingSinks.push_back(std::move(sink));
+    }
+  }
+  pendingSinkFactories.clear();
+  for (auto &sink : pendingSinks) {
+    if (hasFlushPolicy) {
+      sink->setFlushPolicy(flushPolicy);
+    }
+    sinks.push_back(std::move(sink));
+  }
+  pendingSinks.clear();
+  if (workerOptionsChanged) {
+    applyWorkerOptions();
+    workerOptionsChanged = false;
+  }
+  if (flushPolicyChanged) {
+    for (auto &sink : sinks) {
+      sink->setFlushPolicy(flushPolicy);
+    }
+    flushPolicyChanged = false;
+  }
+  sinkChangesPending.store(false, std::memory_order_relaxed);
+}
+
+void LoggerThread::SetWorkerOptions(const LoggerWorkerOptions &options) {
+  std::unique_lock<std::mutex> lock(mtx);
+  workerOptions = options;
+  workerOptionsChanged = true;
+  sinkChangesPending.store(true, std::memory_order_release);
+}
+
+// Called by the worker with mtx held, affinity and nice value are per thread on Linux
+void LoggerThread::applyWorkerOptions() {
+  maxSpin = workerOptions.maxSpin;
+  spinBudget = std::min(spinBudget, maxSpin);
+#ifdef __linux__
+  if (workerOptions.cpu >= 0 && workerOptions.cpu < CPU_SETSIZE) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(workerOptions.cpu, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+  setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), workerOptions.niceValue);
+#endif
+}
+
+void LoggerThread::SetQueueMode(LoggerQueueMode mode, std::size_t capacity) {
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    threadQueueCapacity = capacity;
+  }
+  perThreadQueues.store(mode == LoggerQueueMode::PER_THREAD, std::memory_order_relaxed);
+}
+
+LoggerThreadBuffer &LoggerThread::registerThreadBuffer(LoggerThreadBufferCache &cache) {
+  std::unique_lock<std::mutex> lock(mtx);
+  auto buffer = std::make_shared<LoggerThreadBuffer>(threadQueueCapacity);
+  threadBuffers.push_back(buffer);
+  threadBuffersGeneration.fetch_add(1, std::memory_order_release);
+  cache.entries.emplace_back(instanceId, buffer);
+  return *buffer;
+}
+
+// Worker side: merges the per-thread rings, always writing the oldest front record first
+std::size_t LoggerThread::drainThreadBuffers() {
+  if (activeThreadBuffersGeneration != threadBuffersGeneration.load(std::memory_order_acquire)) {
+    std::unique_lock<std::mutex> lock(mtx);
+    activeThreadBuffers = threadBuffers;
+    activeThreadBuffersGeneration = threadBuffersGeneration.load(std::memory_order_relaxed);
+  }
+  std::size_t drained = 0;
   while (true) {
-    std::function<void()> task;
-    {
-      std::unique_lock<std::mutex> lock(mtx);
-      Unlock_Logger_Thread.wait(lock, [this] { return !tasks.empty() || Done_Logger_Thread; });
-      if (Done_Logger_Thread && tasks.empty()) {
+    LoggerThreadBuffer *oldest = nullptr;
+    const LogRecord *oldestRecord = nullptr;
+    for (auto &buffer : activeThreadBuffers) {
+      const LogRecord *record = buffer->ring.front();
+      if (record != nullptr &&
+          (oldestRecord == nullptr || record->timestamp < oldestRecord->timestamp)) {
+        oldest = buffer.get();
+        oldestRecord = record;
+      }
+    }
+    if (oldest == nullptr) {
+      break;
+    }
+    logMessage(*oldestRecord);
+    oldest->ring.pop();
+    if (++drained % 256 == 0) {
+      releaseBlockedProducers();
+      flushSinksIfDue(false);
+      if (shutdownDeadlinePassed()) {
         break;
       }
-      task = std::move(tasks.front());
-      tasks.pop();
     }
-    task();
   }
+
+  // Buffers of exited threads go away once empty, producerExited is read first so no
+  // record can be pushed after the emptiness check
+  auto retired = [](const std::shared_ptr<LoggerThreadBuffer> &buffer) {
+    return buffer->producerExited.load(std::memory_order_acquire) && buffer->ring.empty();
+  };
+  if (std::any_of(activeThreadBuffers.begin(), activeThreadBuffers.end(), retired)) {
+    std::unique_lock<std::mutex> lock(mtx);
+    std::erase_if(threadBuffers, retired);
+    activeThreadBuffers = threadBuffers;
+    activeThreadBuffersGeneration = threadBuffersGeneration.load(std::memory_order_relaxed);
+  }
+  return drained;
 }
-std::string LoggerThread::formatMessage(
-    LogLevel level, const std::string &sourceFile, int line, const std::string &message) {
-  std::ostringstream oss;
-  switch (level) {
-    case LogLevel::INFO:
-      oss << "[INFO] ";
-      break;
-    case LogLevel::WARNING:
-      oss << "[WARNING] ";
+
+// Worker side check used before parking and before exiting
+bool LoggerThread::hasPendingRecords() {
+  if (!records.empty() ||
+      activeThreadBuffersGeneration != threadBuffersGeneration.load(std::memory_order_acquire)) {
+    return true;
+  }
+  for (auto &buffer : activeThreadBuffers) {
+    if (!buffer->ring.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LoggerThread::handleFullQueue(LogLevel level, bool sharedQueue, int attempt) {
+  // The worker may already be gone, never wait on it during shutdown
+  if (Done_Logger_Thread.load(std::memory_order_relaxed)) {
+    droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  switch (overflowPolicy.load(std::memory_order_relaxed)) {
+    case LoggerOverflowPolicy::BLOCK:
       break;
-    case LogLevel::ERRORING:
-      oss << "[ERROR] ";
+    case LoggerOverflowPolicy::DROP_NEWEST:
+      droppedRecords.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    case LoggerOverflowPolicy::DROP_OLDEST:
+      if (!sharedQueue) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      // The shared ring accepts any number of consumers, the producer pops like the worker
+      if (records.tryPop([](const LogRecord &) {})) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
       break;
-    case LogLevel::LOGICERROR:
-      oss << "[LOGIC ERROR] ";
+    case LoggerOverflowPolicy::DROP_BELOW_LEVEL:
+      if (level < overflowLevel.load(std::memory_order_relaxed)) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
       break;
   }
-  oss << getTimestamp() << " [" << extractRelativePath(sourceFile) << ":" << line << "] "
-      << message;
-  return oss.str();
-}
-
-template <typename... Args>
-void LoggerThread::logMessage(
-    LogLevel level, const std::string &sourceFile, int line, const Args &...args) {
-  std::ostringstream oss;
-  append(oss, args...);
-  std::string message = formatMessage(level, sourceFile, line, oss.str());
-  std::cout << message << std::endl;
-  if (logFile.is_open()) {
-    std::lock_guard<std::mutex> lock(mtx);  // Lock before writing
-    logFile << message << std::endl;        // Write to file
+  wakeWorker();
+  if (attempt < 16) {
+    cpuRelax();
+  } else if (attempt < BlockSpinLimit) {
+    std::this_thread::yield();
   } else {
-    std::cerr << "Error: Unable to write to log file.\n";
+    waitForFreeSlots(sharedQueue);
   }
+  return true;
 }
 
-void LoggerThread::logMessageFallback(
-    LogLevel level,
-    const std::string &sourceFile,
-    int line,
-    const std::initializer_list<std::string> &messageParts) {
-  std::ofstream fallbackLogFile(
-      "fallback_log.txt",
-      std::ios::out | std::ios::app);  // Open in append mode
-  if (!fallbackLogFile.is_open()) {
-    std::cerr << "Error: Unable to open fallback log file.\n";
+// Producer side. Registering before reading the epoch and checking the queue again after,
+// all seq_cst, means the worker either sees the producer registered when it bumps the
+// epoch, or the producer sees the freed slot and retries without sleeping.
+void LoggerThread::waitForFreeSlots(bool sharedQueue) {
+  blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+  std::uint32_t epoch = freedSlotsEpoch.load(std::memory_order_seq_cst);
+  bool full = sharedQueue ? records.full() : threadBuffer().ring.full();
+  if (full && !Done_Logger_Thread.load(std::memory_order_seq_cst)) {
+    freedSlotsEpoch.wait(epoch, std::memory_order_seq_cst);
+  }
+  blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Worker side, called every 256 records and after every pass over the queues
+void LoggerThread::releaseBlockedProducers() {
+  freedSlotsEpoch.fetch_add(1, std::memory_order_seq_cst);
+  if (blockedProducers.load(std::memory_order_seq_cst) > 0) {
+    freedSlotsEpoch.notify_all();
+  }
+}
+
+// Worker side, turns the drop counter into a warning at most once per DropReportInterval
+void LoggerThread::reportDroppedRecords(bool force) {
+  std::uint64_t dropped = droppedRecords.load(std::memory_order_relaxed);
+  if (dropped == reportedDroppedRecords) {
     return;
   }
-  std::ostringstream oss;
-  for (const auto &part : messageParts) {
-    oss << part;
+  auto now = std::chrono::steady_clock::now();
+  if (!force && now - lastDropReport < DropReportInterval) {
+    return;
   }
-  std::string message = formatMessage(level, sourceFile, line, oss.str());
-  std::cout << message << std::endl;
-  fallbackLogFile << message << std::endl;  // Write to fallback log file
-  fallbackLogFile.close();
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+  LogRecord record;
+  record.begin(LogLevel::WARNING, callSite, clock.now());
+  record.category = LoggerSink::AnyCategory;
+  record.push(dropped - reportedDroppedRecords);
+  record.push(LogLiteral(" messages dropped by the logger"));
+  reportedDroppedRecords = dropped;
+  lastDropReport = now;
+  logMessage(record);
 }
 
-std::string LoggerThread::extractRelativePath(const std::string &filePath) {
-  size_t found = filePath.find_last_of("/\\");
-  if (found != std::string::npos) {
-    size_t srcIndex = filePath.rfind(LoggerGlobals::SrcProjectDirectory, found);
-    if (srcIndex != std::string::npos) {
-      return filePath.substr(srcIndex);
+// Worker side, empties every queue without writing and returns the number of records
+std::size_t LoggerThread::discardPendingRecords() {
+  std::size_t discarded = 0;
+  while (records.tryPop([](const LogRecord &) {})) {
+    ++discarded;
+  }
+  for (auto &buffer : activeThreadBuffers) {
+    while (buffer->ring.front() != nullptr) {
+      buffer->ring.pop();
+      ++discarded;
     }
-    return filePath.substr(found);
   }
-  return filePath;
+  return discarded;
 }
 
-template <typename T>
-void LoggerThread::append(std::ostringstream &oss, const T &arg) {
-  oss << arg;
+// Worker side, records waiting in the shared ring and in the per-thread rings
+std::size_t LoggerThread::queueDepth() const {
+  std::size_t depth = records.size();
+  for (auto &buffer : activeThreadBuffers) {
+    depth += buffer->ring.size();
+  }
+  return depth;
 }
 
-template <typename T, typename... Args>
-void LoggerThread::append(std::ostringstream &oss, const T &first, const Args &...args) {
-  oss << first;
-  append(oss, args...);
+void LoggerThread::reportMetrics() {
+  auto interval = std::chrono::seconds(metricsReportInterval.load(std::memory_order_relaxed));
+  auto now = std::chrono::steady_clock::now();
+  if (interval.count() <= 0 || now - lastMetricsReport < interval) {
+    return;
+  }
+  lastMetricsReport = now;
+  LoggerMetricsSnapshot snapshot = GetMetrics();
+  std::uint64_t enqueued = 0;
+  std::uint64_t written = 0;
+  for (std::size_t i = 0; i < LoggerLevelCount; ++i) {
+    enqueued += snapshot.enqueued[i];
+    written += snapshot.written[i];
+  }
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+  LogRecord record;
+  record.begin(LogLevel::INFO, callSite, clock.now());
+  record.category = LoggerSink::AnyCategory;
+  record.push(LogLiteral("Logger metrics: enqueued "));
+  record.push(enqueued);
+  record.push(LogLiteral(", written "));
+  record.push(written);
+  record.push(LogLiteral(", dropped "));
+  record.push(snapshot.dropped);
+  record.push(LogLiteral(", queue high water "));
+  record.push(snapshot.queueHighWater);
+  record.push(LogLiteral(", enqueue to write p50/p99/p999/max "));
+  record.push(snapshot.enqueueToWrite.p50);
+  record.push('/');
+  record.push(snapshot.enqueueToWrite.p99);
+  record.push('/');
+  record.push(snapshot.enqueueToWrite.p999);
+  record.push('/');
+  record.push(snapshot.enqueueToWrite.max);
+  record.push(LogLiteral(" ns, sink write p50/p99/p999/max "));
+  record.push(snapshot.sinkWrite.p50);
+  record.push('/');
+  record.push(snapshot.sinkWrite.p99);
+  record.push('/');
+  record.push(snapshot.sinkWrite.p999);
+  record.push('/');
+  record.push(snapshot.sinkWrite.max);
+  record.push(LogLiteral(" ns, sink flush p50/p99/p999/max "));
+  record.push(snapshot.sinkFlush.p50);
+  record.push('/');
+  record.push(snapshot.sinkFlush.p99);
+  record.push('/');
+  record.push(snapshot.sinkFlush.p999);
+  record.push('/');
+  record.push(snapshot.sinkFlush.max);
+  record.push(LogLiteral(" ns"));
+  logMessage(record);
 }
 
-void LoggerThread::copyFile(const std::string &source, const std::string &dest) {
-  std::ifstream src(source, std::ios::binary);
-  if (!src.is_open()) {
-    std::cerr << "Error: Unable to open source file " << source << ".\n";
-    return;
+// File sinks mostly buffer in write, their write syscalls happen here and in flushSinks
+void LoggerThread::flushSinksIfDue(bool queueEmpty) {
+  std::uint64_t start = metricsEnabled.load(std::memory_order_relaxed) ? clock.now() : 0;
+  for (auto &sink : sinks) {
+    sink->flushIfDue(queueEmpty);
+  }
+  if (start != 0) {
+    recordSinkFlush(start);
   }
+}
 
-  std::ofstream dst(dest, std::ios::binary);
-  if (!dst.is_open()) {
-    std::cerr << "Error: Unable to create or open destination file " << dest << ".\n";
-    src.close();
-    return;
+void LoggerThread::flushSinks() {
+  std::uint64_t start = metricsEnabled.load(std::memory_order_relaxed) ? clock.now() : 0;
+  for (auto &sink : sinks) {
+    sink->flush();
+  }
+  if (start != 0) {
+    recordSinkFlush(start);
   }
-  dst << src.rdbuf();  // Efficiently copy file
-  src.close();
-  dst.close();
 }
 
-std::string LoggerThread::getTimestamp() {
-  auto now = std::chrono::system_clock::now();
-  auto in_time_t = std::chrono::system_clock::to_time_t(now);
+void LoggerThread::recordSinkFlush(std::uint64_t startTicks) {
+  std::int64_t elapsed =
+      clock.toSystemNanoseconds(clock.now()) - clock.toSystemNanoseconds(startTicks);
+  metrics.sinkFlush.record(static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed, 0)));
+}
 
-  struct tm timeinfo;
+// Worker side: polls a little before parking, most bursts continue within microseconds and
+// parking would cost the producer a futex wake. The budget doubles when polling finds work
+// and halves when it runs out, so an idle game quickly stops spending CPU on the logger.
+bool LoggerThread::spinForWork() {
+  for (std::uint32_t i = 0; i < spinBudget; ++i) {
+    if (hasWork()) {
+      spinBudget = std::min(spinBudget * 2, maxSpin);
+      return true;
+    }
+    // Pause keeps the core to a sibling hyperthread, yield lets a producer on this core run
+    if (i < 32) {
+      cpuRelax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  spinBudget = std::min(std::max(spinBudget / 2, MinSpin), maxSpin);
+  return false;
+}
 
-#ifdef _WIN32
-  localtime_s(&timeinfo, &in_time_t);
-#else
-  localtime_r(&timeinfo, &in_time_t);
-#endif
+void LoggerThread::logWorker() {
+  auto consume = [this](const LogRecord &record) { logMessage(record); };
+  while (true) {
+    if (metricsEnabled.load(std::memory_order_relaxed)) {
+      metrics.updateQueueHighWater(queueDepth());
+      reportMetrics();
+    }
+    std::uint64_t batchStart = tracingEnabled.load(std::memory_order_relaxed) ? clock.now() : 0;
+    std::size_t drained = 0;
+    while (records.tryPop(consume)) {
+      // A burst can keep the queue busy for a long time, honour the interval policy meanwhile
+      if (++drained % 256 == 0) {
+        releaseBlockedProducers();
+        flushSinksIfDue(false);
+        if (metricsEnabled.load(std::memory_order_relaxed)) {
+          metrics.updateQueueHighWater(queueDepth());
+        }
+        if (shutdownDeadlinePassed()) {
+          break;
+        }
+      }
+    }
+    drained += drainThreadBuffers();
+    releaseBlockedProducers();
+    if (batchStart != 0) {
+      traceWorkerBatch(batchStart, drained);
+    }
+    reportDroppedRecords(false);
+    reportRepeatedRecords(false);
+    if (dumpRequested.exchange(false, std::memory_order_relaxed)) {
+      for (auto &sink : sinks) {
+        sink->dump();
+      }
+    }
+    flushSinksIfDue(true);
+    std::unique_lock<std::mutex> lock(mtx);
+    applyPendingSinkChanges();
+    // Shutdown drains everything that was queued, up to the shutdown deadline
+    if (Done_Logger_Thread && (!hasPendingRecords() || shutdownDeadlinePassed())) {
+      droppedRecords.fetch_add(discardPendingRecords(), std::memory_order_relaxed);
+      reportRepeatedRecords(true);
+      reportDroppedRecords(true);
+      flushSinks();
+      break;
+    }
+    lock.unlock();
+    if (spinForWork()) {
+      continue;
+    }
+    lock.lock();
+    workerSleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // The timeout keeps the interval flush and age rotation going while nothing is logged
+    Unlock_Logger_Thread.wait_for(
+        lock, std::chrono::milliseconds(10), [this] { return hasWork(); });
+    workerSleeping.store(false, std::memory_order_relaxed);
+    applyPendingSinkChanges();
+  }
+}
+
+// Worker side, returns true when record only adds to the repeat count of the previous one
+bool LoggerThread::collapseRepeat(const LogRecord &record) {
+  if (!collapseRepeats.load(std::memory_order_relaxed)) {
+    reportRepeatedRecords(true);
+    hasLastRecord = false;
+    return false;
+  }
+  if (hasLastRecord && lastRecord.sameMessage(record)) {
+    if (repeatedRecords++ == 0) {
+      lastRepeatReport = std::chrono::steady_clock::now();
+    }
+    return true;
+  }
+  reportRepeatedRecords(true);
+  lastRecord = record;
+  hasLastRecord = true;
+  return false;
+}
+
+// Worker side, writes "Last message repeated N times" under the call site of the repeated record
+void LoggerThread::reportRepeatedRecords(bool force) {
+  if (repeatedRecords == 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (!force && now - lastRepeatReport < RepeatReportInterval) {
+    return;
+  }
+  LogRecord record;
+  if (lastRecord.callSite != nullptr) {
+    record.begin(lastRecord.level, *lastRecord.callSite, clock.now());
+  } else {
+    record.begin(lastRecord.level, lastRecord.file(), lastRecord.line, clock.now());
+  }
+  record.category = lastRecord.category;  // Goes to the sinks that got the repeated record
+  record.push(LogLiteral("Last message repeated "));
+  record.push(repeatedRecords);
+  record.push(LogLiteral(" times"));
+  repeatedRecords = 0;
+  lastRepeatReport = now;
+  writeRecord(record);
+}
+
+void LoggerThread::logMessage(const LogRecord &record) {
+  // A sink added before this record was queued has to receive it
+  if (sinkChangesPending.load(std::memory_order_acquire)) {
+    std::unique_lock<std::mutex> lock(mtx);
+    applyPendingSinkChanges();
+  }
+  if ((hasLastRecord || collapseRepeats.load(std::memory_order_relaxed)) &&
+      collapseRepeat(record)) {
+    return;
+  }
+  writeRecord(record);
+}
 
-  char buffer[80];
-  strftime(buffer, sizeof(buffer), "%Y-%m-%d-%H-%M-%S", &timeinfo);
+void LoggerThread::writeRecord(const LogRecord &record) {
+  formatter.reset(record);
+  if (!metricsEnabled.load(std::memory_order_relaxed)) {
+    for (auto &sink : sinks) {
+      if (sink->accepts(record)) {
+        sink->write(formatter);
+      }
+    }
+    return;
+  }
+  std::uint64_t start = clock.now();
+  for (auto &sink : sinks) {
+    if (sink->accepts(record)) {
+      sink->write(formatter);
+    }
+  }
+  std::int64_t end = clock.toSystemNanoseconds(clock.now());
+  metrics.sinkWrite.record(static_cast<std::uint64_t>(
+      std::max<std::int64_t>(end - clock.toSystemNanoseconds(start), 0)));
+  metrics.enqueueToWrite.record(static_cast<std::uint64_t>(
+      std::max<std::int64_t>(end - clock.toSystemNanoseconds(record.timestamp), 0)));
+  metrics.countWritten(record.level);
+}
 
-  return std::string(buffer);
+// Worker side, the span of one pass over the queues goes straight to the sinks
+void LoggerThread::traceWorkerBatch(std::uint64_t startTicks, std::size_t written) {
+  if (written == 0) {
+    return;
+  }
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+  LogRecord record;
+  record.begin(LogLevel::INFO, callSite, clock.now());
+  record.span = true;
+  record.push(LogLiteral("logger batch"));
+  record.push(startTicks);
+  record.push(LoggerTraceThread::index());
+  writeRecord(record);
 }
-void LoggerThread::cleanup() {
+
+void LoggerThread::cleanup(bool archiveSinks) {
   {
     std::unique_lock<std::mutex> lock(mtx);
+    shutdownDeadline = std::chrono::steady_clock::now() +
+                       std::chrono::milliseconds(shutdownTimeout.load(std::memory_order_relaxed));
     Done_Logger_Thread = true;
     Unlock_Logger_Thread.notify_one();  // Notify worker thread to stop
   }
-  std::queue<std::function<void()>> emptyQueue; // Made tasks queue empty to exit thread instantly when cleanuping it
-  std::swap(tasks, emptyQueue);
   if (workerThread.joinable()) {
     workerThread.join();  // Wait for worker thread to finish
   }
-  if (logFile.is_open()) {
-    logFile.close();
+  releaseBlockedProducers();  // Producers still parked see Done_Logger_Thread and drop
+  if (archiveSinks) {
+    for (auto &sink : sinks) {
+      sink->archive();
+    }
   }
+  sinks.clear();  // Flushes and closes every sink
 }
\ No newline at end of file
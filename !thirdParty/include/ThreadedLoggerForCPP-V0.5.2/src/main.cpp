@@ -1,12 +1,21 @@
 #include <ThreadedLoggerForCPP/LoggerThread.h>
 
+#include <ThreadedLoggerForCPP/LoggerCategoryPool.hpp>
 #include <ThreadedLoggerForCPP/LoggerFileSystem.hpp>
 #include <ThreadedLoggerForCPP/LoggerGlobals.hpp>
+#include <ThreadedLoggerForCPP/LoggerUringSink.hpp>
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "CreateGlobalsLoggerInstanceExample.h"
 
@@ -42,6 +51,66 @@ void testLoggingSpeed() {
       " milliseconds\n";
   CreateGlobalsLoggerInstanceExample::LoggerInstance
       .logMessageAsync(LogLevel::INFO, __FILE__, __LINE__, durationLogAsyncStr);
+
+  // Worker side cost of one line: std::ostringstream as the logger used to do, the argument
+  // list of LOGGER_THREAD and the pattern of LOGGER_THREAD_FORMAT, each into a reused buffer
+  const int numFormats = 100000;
+  double frameTime = 16.6667;
+  std::string line;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numFormats; ++i) {
+    std::ostringstream stream;
+    stream << "frame " << i << " took " << frameTime << " ms";
+    line = stream.str();
+  }
+  auto streamTime = std::chrono::high_resolution_clock::now() - start;
+
+  LogRecord record;
+  auto formatRecords = [&](auto &&fill) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numFormats; ++i) {
+      record.begin(LogLevel::INFO, __FILE__, __LINE__, 0);
+      fill(i);
+      line.clear();
+      record.appendMessage(line);
+    }
+    return std::chrono::high_resolution_clock::now() - begin;
+  };
+  auto argsTime = formatRecords([&](int i) {
+    record.push(LogLiteral("frame "));
+    record.push(i);
+    record.push(LogLiteral(" took "));
+    record.push(frameTime);
+    record.push(LogLiteral(" ms"));
+  });
+  auto formatTime = formatRecords([&](int i) {
+    record.push(LoggerFormatString<int, double>("frame {} took {} ms"));
+    record.push(i);
+    record.push(frameTime);
+  });
+  auto specTime = formatRecords([&](int i) {
+    record.push(LoggerFormatString<int, double>("frame {} took {:.2f} ms"));
+    record.push(i);
+    record.push(frameTime);
+  });
+  auto nanosecondsPerLine = [&](auto duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / numFormats;
+  };
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Formatting one line: ostringstream ",
+      nanosecondsPerLine(streamTime),
+      " ns, arguments ",
+      nanosecondsPerLine(argsTime),
+      " ns, format string ",
+      nanosecondsPerLine(formatTime),
+      " ns, format string with spec ",
+      nanosecondsPerLine(specTime),
+      " ns (",
+      line,
+      ")");
 }
 void testLoggingGetThreadSpeed() {
   const int numIterations = 1000;
@@ -78,28 +147,437 @@ void testLoggingGetThreadSpeed() {
       .logMessageAsync(LogLevel::INFO, __FILE__, __LINE__, test2);
 }
 
-void InitThreadedLoggerForCPP(
-    std::string &ProjectDirectory, std::string &LogFileName, std::string &GameSaveFolder) {
-#pragma warning(push)
-#pragma warning(disable : 4996)  // Disable warning for getenv
+void testTypedLoggingSpeed() {
+  const int numIterations = 1000;
+  const double frameTime = 16.6;
+
+  // Message built with std::string on the calling thread
+  auto start1 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    CreateGlobalsLoggerInstanceExample::LoggerInstance.logMessageAsync(
+        LogLevel::INFO,
+        __FILE__,
+        __LINE__,
+        "frame " + std::to_string(i) + " took " + std::to_string(frameTime) + "ms");
+  }
+  auto end1 = std::chrono::high_resolution_clock::now();
+  auto duration1 = std::chrono::duration_cast<std::chrono::microseconds>(end1 - start1);
+
+  // Raw arguments copied into the record, formatted on the worker thread
+  auto start2 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+        LogLevel::INFO, __FILE__, __LINE__, LogLiteral("frame "), i, " took ", frameTime, "ms");
+  }
+  auto end2 = std::chrono::high_resolution_clock::now();
+  auto duration2 = std::chrono::duration_cast<std::chrono::microseconds>(end2 - start2);
+  std::string test1 = "Time taken with caller side string formatting: " +
+                      std::to_string(duration1.count()) + " microseconds\n";
+  CreateGlobalsLoggerInstanceExample::LoggerInstance
+      .logMessageAsync(LogLevel::INFO, __FILE__, __LINE__, test1);
+  std::string test2 = "Time taken with deferred formatting: " + std::to_string(duration2.count()) +
+                      " microseconds\n";
+  CreateGlobalsLoggerInstanceExample::LoggerInstance
+      .logMessageAsync(LogLevel::INFO, __FILE__, __LINE__, test2);
+}
+
+void testDisabledLevelSpeed() {
+  const int numIterations = 1000000;
+  int evaluated = 0;
+  auto countEvaluation = [&evaluated]() { return ++evaluated; };
+
+  // The runtime threshold is checked before the arguments are evaluated
+  LoggerThread::GetLoggerThread().SetLogLevel(LogLevel::WARNING);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    LOGGER_THREAD(LogLevel::INFO, "filtered out ", countEvaluation())
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  LoggerThread::GetLoggerThread().SetLogLevel(LogLevel::INFO);
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Disabled level: ",
+      static_cast<double>(duration.count()) / numIterations,
+      " ns per call, arguments evaluated ",
+      evaluated,
+      " times");
+}
+
+// Same steps as the per message timestamp LoggerThread used before the cached formatter
+std::string formatTimestampUncached() {
+  auto now = std::chrono::system_clock::now();
+  auto in_time_t = std::chrono::system_clock::to_time_t(now);
+  struct tm timeinfo;
 #ifdef _WIN32
-  LoggerGlobals::UsernameDirectory = std::getenv("USERNAME");
+  localtime_s(&timeinfo, &in_time_t);
 #else
-  LoggerGlobals::UsernameDirectory = std::getenv("USER");
+  localtime_r(&in_time_t, &timeinfo);
 #endif
-#pragma warning(pop)
+  char buffer[80];
+  strftime(buffer, sizeof(buffer), "%Y-%m-%d-%H-%M-%S", &timeinfo);
+  return std::string(buffer);
+}
+
+void testTimestampSpeed() {
+  const int numIterations = 100000;
+  std::size_t checksum = 0;
+
+  auto start1 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    checksum += formatTimestampUncached().size();
+  }
+  auto end1 = std::chrono::high_resolution_clock::now();
+  auto duration1 = std::chrono::duration_cast<std::chrono::nanoseconds>(end1 - start1);
+  std::string result = "Uncached timestamp: " +
+                       std::to_string(duration1.count() / numIterations) + " ns per message\n";
+  CreateGlobalsLoggerInstanceExample::LoggerInstance
+      .logMessageAsync(LogLevel::INFO, __FILE__, __LINE__, result);
+
+  const std::pair<LoggerClockSource, const char *> sources[] = {
+      {LoggerClockSource::SYSTEM, "system_clock"},
+      {LoggerClockSource::MONOTONIC_COARSE, "monotonic coarse"},
+      {LoggerClockSource::TSC, "TSC"}};
+  for (const auto &[source, name] : sources) {
+    LoggerClock clock(source);
+    LoggerTimestamp timestamps;
+
+    // Producer side capture only
+    auto start2 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numIterations; ++i) {
+      checksum += clock.now() & 1;
+    }
+    auto end2 = std::chrono::high_resolution_clock::now();
+
+    // Capture plus the worker side conversion and cached formatting
+    auto start3 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numIterations; ++i) {
+      checksum += timestamps.format(clock.toSystemNanoseconds(clock.now())).size();
+    }
+    auto end3 = std::chrono::high_resolution_clock::now();
+    auto duration2 = std::chrono::duration_cast<std::chrono::nanoseconds>(end2 - start2);
+    auto duration3 = std::chrono::duration_cast<std::chrono::nanoseconds>(end3 - start3);
+    CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+        LogLevel::INFO,
+        __FILE__,
+        __LINE__,
+        "Cached timestamp with ",
+        name,
+        ": capture ",
+        duration2.count() / numIterations,
+        " ns, capture and format ",
+        duration3.count() / numIterations,
+        " ns per message");
+  }
+  CreateGlobalsLoggerInstanceExample::LoggerInstance
+      .logAsync(LogLevel::INFO, __FILE__, __LINE__, "Timestamp checksum ", checksum);
+}
+
+// Queue and worker throughput without I/O: a private logger with no sinks, timed from the go
+// flag until the last producer returns. logger_bench --threads=1,2,4,8,16 covers real sinks.
+void testLoggingThreadScaling(LoggerQueueMode mode, const char *modeName) {
+  const int messagesPerThread = 100000;
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+
+  for (int numThreads = 1; numThreads <= 16; numThreads *= 2) {
+    LoggerThread logger(LoggerClockSource::SYSTEM);
+    logger.ClearSinks();
+    logger.SetQueueMode(mode);
+
+    std::atomic<bool> go(false);
+    std::vector<std::chrono::steady_clock::time_point> finished(numThreads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; ++t) {
+      producers.emplace_back([&, t] {
+        while (!go.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        for (int i = 0; i < messagesPerThread; ++i) {
+          logger.logAsync(LogLevel::INFO, callSite, LogLiteral("scaling test "), i);
+        }
+        finished[t] = std::chrono::steady_clock::now();
+      });
+    }
+    // Let every producer reach the go flag before the clock starts
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    auto end = *std::max_element(finished.begin(), finished.end());
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double totalMessages = static_cast<double>(messagesPerThread) * numThreads;
+    std::uint64_t dropped = logger.DroppedMessages();
+    CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+        LogLevel::INFO,
+        __FILE__,
+        __LINE__,
+        "Producer throughput with ",
+        numThreads,
+        " threads (",
+        modeName,
+        " queue): ",
+        static_cast<long long>(seconds > 0 ? totalMessages / seconds : 0.0),
+        " messages/second, ",
+        dropped,
+        " of ",
+        static_cast<long long>(totalMessages),
+        " dropped");
+  }
+}
+
+void testBinaryEncodingSpeed() {
+  const int numIterations = 100000;
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+  LoggerClock clock;
+  LoggerFormatter formatter(clock);
+  LogRecord record;
+  std::string out;
+  std::size_t textBytes = 0;
+  std::size_t binaryBytes = 0;
+
+  // Worker side cost of one record, text line against LoggerBinarySink encoding
+  auto start1 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    record.begin(LogLevel::INFO, callSite, clock.now());
+    record.push(LogLiteral("frame "));
+    record.push(i);
+    record.push(LogLiteral(" took "));
+    record.push(16.6);
+    record.push(LogLiteral("ms"));
+    formatter.reset(record);
+    textBytes += formatter.text().size() + 1;
+  }
+  auto end1 = std::chrono::high_resolution_clock::now();
+
+  LoggerBinaryEncoder encoder;
+  auto start2 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    record.begin(LogLevel::INFO, callSite, clock.now());
+    record.push(LogLiteral("frame "));
+    record.push(i);
+    record.push(LogLiteral(" took "));
+    record.push(16.6);
+    record.push(LogLiteral("ms"));
+    formatter.reset(record);
+    out.clear();
+    encoder.append(out, formatter);
+    binaryBytes += out.size();
+  }
+  auto end2 = std::chrono::high_resolution_clock::now();
+  auto duration1 = std::chrono::duration_cast<std::chrono::nanoseconds>(end1 - start1);
+  auto duration2 = std::chrono::duration_cast<std::chrono::nanoseconds>(end2 - start2);
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Text records: ",
+      duration1.count() / numIterations,
+      " ns and ",
+      textBytes / numIterations,
+      " bytes each, binary records: ",
+      duration2.count() / numIterations,
+      " ns and ",
+      binaryBytes / numIterations,
+      " bytes each");
+}
 
+void testLoggerMetrics() {
+  auto &logger = CreateGlobalsLoggerInstanceExample::LoggerInstance;
+  logger.EnableMetrics(true);
+  for (int i = 0; i < 10000; ++i) {
+    logger.logAsync(LogLevel::INFO, __FILE__, __LINE__, LogLiteral("metrics test "), i);
+  }
+  // Let the worker write everything before reading the histograms
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  LoggerMetricsSnapshot metrics = logger.GetMetrics();
+  logger.EnableMetrics(false);
+  logger.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Metrics: written ",
+      metrics.written[static_cast<std::size_t>(LogLevel::INFO)],
+      ", queue high water ",
+      metrics.queueHighWater,
+      ", enqueue to write p50 ",
+      metrics.enqueueToWrite.p50,
+      " ns p99 ",
+      metrics.enqueueToWrite.p99,
+      " ns max ",
+      metrics.enqueueToWrite.max,
+      " ns, sink write p50 ",
+      metrics.sinkWrite.p50,
+      " ns p99 ",
+      metrics.sinkWrite.p99,
+      " ns, sink flush p99 ",
+      metrics.sinkFlush.p99,
+      " ns max ",
+      metrics.sinkFlush.max,
+      " ns");
+}
+
+void testRateLimitedLogging() {
+  const int numIterations = 1000000;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    LOGGER_THREAD_EVERY_N(250000, LogLevel::WARNING, LogLiteral("every n "), i)
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto everyN = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    LOGGER_THREAD_RATE(2, LogLevel::WARNING, LogLiteral("rate limited "), i)
+  }
+  end = std::chrono::high_resolution_clock::now();
+  auto rate = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+  for (int i = 0; i < 3; ++i) {
+    LOGGER_THREAD_ONCE(LogLevel::WARNING, LogLiteral("logged once"))
+  }
+
+  // An error storm from one line ends up as two lines in the log
+  auto &logger = CreateGlobalsLoggerInstanceExample::LoggerInstance;
+  logger.SetCollapseRepeats(true);
+  for (int i = 0; i < 1000; ++i) {
+    logger.logAsync(LogLevel::WARNING, __FILE__, __LINE__, LogLiteral("texture missing"));
+  }
+  logger.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Suppressed calls: every n ",
+      everyN.count() / numIterations,
+      " ns, rate ",
+      rate.count() / numIterations,
+      " ns");
+  // Collapsing applies when the worker writes, let it catch up before turning it off
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  logger.SetCollapseRepeats(false);
+}
+
+void testStructuredLogging() {
+  const int numIterations = 10000;
+  auto start = std::chrono::high_resolution_clock::now();
+  {
+    LoggerThread logger;
+    logger.ClearSinks();
+    logger.AddSink(
+        std::make_unique<LoggerJsonSink>(LoggerGlobals::LogFolderPath + "frames.jsonl", true));
+    static constinit LoggerCallSite site(__FILE__, __LINE__);
+    for (int i = 0; i < numIterations; ++i) {
+      logger.logFields(LogLevel::INFO, site, "frame", "index", i, "ms", 16.6, "draws", 120);
+    }
+  }  // The destructor drains the queue
+  auto end = std::chrono::high_resolution_clock::now();
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Structured records written as JSON lines: ",
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / numIterations,
+      " ns each");
+}
+
+void testTracing() {
+  const int numIterations = 10000;
+  std::size_t checksum = 0;
+  // Scopes record into GetLoggerThread, open trace.json in ui.perfetto.dev
+  LoggerThread &logger = LoggerThread::GetLoggerThread();
+  logger.AddSink(std::make_unique<LoggerTraceSink>(LoggerGlobals::LogFolderPath + "trace.json"));
+  logger.EnableTracing(true);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numIterations; ++i) {
+    LOGGER_TRACE_SCOPE("frame");
+    {
+      LOGGER_TRACE_SCOPE("update");
+      checksum += static_cast<std::size_t>(i);
+    }
+    {
+      LOGGER_TRACE_SCOPE("draw");
+      checksum ^= static_cast<std::size_t>(i) << 1;
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  logger.EnableTracing(false);
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Trace scopes: ",
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+          (3 * numIterations),
+      " ns each (checksum ",
+      checksum,
+      ")");
+}
+
+// Stands for an output that cannot keep up, such as a log shipped over the network
+class SlowSink : public LoggerSink {
+ public:
+  void write(LoggerFormatter &) override {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+};
+
+void testCategoryLogging() {
+  const int numIterations = 2000;
+  auto start = std::chrono::high_resolution_clock::now();
+  std::chrono::high_resolution_clock::time_point renderWritten;
+  {
+    LoggerCategoryPool categories(2);
+    auto renderSink = std::make_unique<LoggerNullSink>();
+    LoggerNullSink *render = renderSink.get();
+    const LoggerCategory &renderLog = categories.AddCategory("render", std::move(renderSink), 0);
+    const LoggerCategory &assetsLog = categories.AddCategory(
+        "assets",
+        std::make_unique<LoggerFileSink>(LoggerGlobals::LogFolderPath + "assets.log", true),
+        0);
+    const LoggerCategory &netLog = categories.AddCategory("net", std::make_unique<SlowSink>(), 1);
+    for (int i = 0; i < numIterations; ++i) {
+      LOGGER_THREAD_CATEGORY(renderLog, LogLevel::INFO, "frame ", i)
+      LOGGER_THREAD_CATEGORY(assetsLog, LogLevel::INFO, "streamed chunk ", i)
+      LOGGER_THREAD_CATEGORY(netLog, LogLevel::INFO, "packet ", i)
+    }
+    // The net worker is still busy, the render worker is not waiting for it
+    while (render->recordsWritten() < static_cast<std::uint64_t>(numIterations)) {
+      std::this_thread::yield();
+    }
+    renderWritten = std::chrono::high_resolution_clock::now();
+  }  // The destructor drains the net category
+  auto end = std::chrono::high_resolution_clock::now();
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      LogLevel::INFO,
+      __FILE__,
+      __LINE__,
+      "Categories: render written after ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(renderWritten - start).count(),
+      " ms, slow net category after ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+      " ms");
+}
+
+void InitThreadedLoggerForCPP(
+    std::string &ProjectDirectory, std::string &LogFileName, std::string &GameSaveFolder) {
   // this is the folder that contains your src files like main.cpp
   LoggerGlobals::SrcProjectDirectory = ProjectDirectory;
-  // Create Log File and folder
-  LoggerGlobals::LogFolderPath =
-      "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." + GameSaveFolder + "\\logging\\";
-  LoggerGlobals::LogFilePath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                               GameSaveFolder + "\\logging\\" + LogFileName + ".log";
-  LoggerGlobals::LogFolderBackupPath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                                       GameSaveFolder + "\\logging\\LogBackup";
-  LoggerGlobals::LogFileBackupPath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                                     GameSaveFolder + "\\logging\\LogBackup\\" + LogFileName + "-";
+  // Log folder of the current user, $XDG_STATE_HOME or ~/.local/state on Linux and
+  // %USERPROFILE%\\.GameSaveFolder on Windows
+  std::filesystem::path logFolder = LoggerFileSystem::defaultLogFolder(GameSaveFolder);
+  LoggerGlobals::LogFolderPath = (logFolder / "").string();
+  LoggerGlobals::LogFilePath = (logFolder / (LogFileName + ".log")).string();
+  LoggerGlobals::LogFolderBackupPath = (logFolder / "LogBackup").string();
+  LoggerGlobals::LogFileBackupPath = (logFolder / "LogBackup" / (LogFileName + "-")).string();
+
+  // The log file moves to LogBackup every MiB, only the 5 newest backups are kept
+  LoggerRotationPolicy rotation;
+  rotation.maxFileBytes = 1024 * 1024;
+  rotation.maxBackups = 5;
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.SetRotationPolicy(rotation);
 
   CreateGlobalsLoggerInstanceExample::LoggerInstance.StartLoggerThread(
       LoggerGlobals::LogFolderPath,
@@ -107,10 +585,72 @@ void InitThreadedLoggerForCPP(
       LoggerGlobals::LogFolderBackupPath,
       LoggerGlobals::LogFileBackupPath);
 }
+// Every other io_uring submission fails, the file must still hold every line once and in order
+void testUringSubmitFailure() {
+#if LOGGER_THREAD_HAS_IO_URING
+  const int numLines = 20000;
+  std::string path = (std::filesystem::temp_directory_path() / "logger_uring_test.log").string();
+  static std::atomic<unsigned> submits{0};
+  static constinit LoggerCallSite callSite(__FILE__, __LINE__);
+  LoggerUring::submitFault = [] { return submits.fetch_add(1) % 2 == 0; };
+  {
+    LoggerUringFileSink sink(path, true, LogLevel::INFO, 4096);
+    LoggerClock clock;
+    LoggerFormatter formatter(clock);
+    LogRecord record;
+    for (int i = 0; i < numLines; ++i) {
+      record.begin(LogLevel::INFO, callSite, clock.now());
+      record.push(LogLiteral("uring line "));
+      record.push(i);
+      formatter.reset(record);
+      sink.write(formatter);
+    }
+  }
+  LoggerUring::submitFault = nullptr;
+
+  std::ifstream file(path);
+  std::string line;
+  int lines = 0;
+  int misplaced = 0;
+  while (std::getline(file, line)) {
+    if (!line.ends_with("uring line " + std::to_string(lines))) {
+      ++misplaced;
+    }
+    ++lines;
+  }
+  std::filesystem::remove(path);
+  CreateGlobalsLoggerInstanceExample::LoggerInstance.logAsync(
+      lines == numLines && misplaced == 0 ? LogLevel::INFO : LogLevel::ERRORING,
+      __FILE__,
+      __LINE__,
+      "Uring submit failure test: ",
+      lines,
+      " of ",
+      numLines,
+      " lines, ",
+      misplaced,
+      " out of place, ",
+      submits.load(),
+      " submissions");
+#endif
+}
+
 int main(int argc, char *args[]) {
   InitThreadedLoggerForCPP(_exe_game, _exe_game, _exe_game);
   testLoggingSpeed();
   testLoggingGetThreadSpeed();
+  testTypedLoggingSpeed();
+  testTimestampSpeed();
+  testDisabledLevelSpeed();
+  testBinaryEncodingSpeed();
+  testLoggerMetrics();
+  testRateLimitedLogging();
+  testStructuredLogging();
+  testTracing();
+  testCategoryLogging();
+  testUringSubmitFailure();
+  testLoggingThreadScaling(LoggerQueueMode::SHARED, "shared");
+  testLoggingThreadScaling(LoggerQueueMode::PER_THREAD, "per-thread");
   CreateGlobalsLoggerInstanceExample::LoggerInstance.ExitLoggerThread();
   return 0;
 }
@@ -0,0 +1,60 @@
+#include <ThreadedLoggerForCPP/LoggerBinaryFormat.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Converts a log written by LoggerBinarySink back to text:
+//   logdecode game.tlog > game.log
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <binary log> [output file]" << std::endl;
+    return 2;
+  }
+  std::ifstream input(argv[1], std::ios::binary);
+  if (!input) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+  std::ofstream outputFile;
+  if (argc > 2) {
+    outputFile.open(argv[2], std::ios::binary | std::ios::trunc);
+    if (!outputFile) {
+      std::cerr << "cannot create " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+  std::ostream &output = argc > 2 ? static_cast<std::ostream &>(outputFile) : std::cout;
+
+  LoggerBinaryDecoder decoder;
+  std::string pending;
+  std::string text;
+  char chunk[64 * 1024];
+  while (input) {
+    input.read(chunk, sizeof(chunk));
+    pending.append(chunk, static_cast<std::size_t>(input.gcount()));
+    text.clear();
+    pending.erase(0, decoder.decode(pending, text));
+    output.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (decoder.status() != LoggerBinaryDecoder::Status::OK) {
+      break;
+    }
+  }
+  output.flush();
+
+  switch (decoder.status()) {
+    case LoggerBinaryDecoder::Status::BAD_MAGIC:
+      std::cerr << argv[1] << " is not a binary log" << std::endl;
+      return 1;
+    case LoggerBinaryDecoder::Status::CORRUPTED:
+      std::cerr << "corrupted entry, decoding stopped" << std::endl;
+      return 1;
+    case LoggerBinaryDecoder::Status::OK:
+      break;
+  }
+  if (!pending.empty()) {
+    std::cerr << "ignored " << pending.size() << " trailing bytes of an incomplete entry"
+              << std::endl;
+  }
+  return 0;
+}
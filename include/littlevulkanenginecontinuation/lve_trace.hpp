@@ -0,0 +1,9 @@
+// See LICENSE file at the root of LittleVulkanEngineContinuation project
+
+#pragma once
+
+#include <ThreadedLoggerForCPP/LoggerThread.h>
+
+// Engine spelling of LOGGER_TRACE_SCOPE, the span ends with the enclosing scope:
+//   LVE_TRACE_SCOPE("FirstApp::run");
+#define LVE_TRACE_SCOPE(name) LOGGER_TRACE_SCOPE(name)
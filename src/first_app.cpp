@@ -1,4 +1,5 @@
 #include <littlevulkanenginecontinuation/first_app.hpp>
+#include <littlevulkanenginecontinuation/lve_trace.hpp>
 
 namespace lve {
 
@@ -8,6 +9,6 @@ FirstApp::FirstApp() {
 FirstApp::~FirstApp() {}
 
 void FirstApp::run() {
-
+  LVE_TRACE_SCOPE("FirstApp::run");
 }
 }  // namespace lve
@@ -4,7 +4,9 @@
 #include <ThreadedLoggerForCPP/LoggerFileSystem.hpp>
 #include <ThreadedLoggerForCPP/LoggerGlobals.hpp>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <littlevulkanenginecontinuation/first_app.hpp>
 #include <stdexcept>
 
@@ -14,31 +16,34 @@ std::string const g_exeGame = "LittleVulkanEngineContinuation";
 // Function to initialize the threaded logger
 void initThreadedLoggerForCPP(
     std::string const &projectDirectory, std::string const &logFileName, std::string const &gameSaveFolder) {
-#pragma warning(push)
-#pragma warning(disable : 4996)  // Disable warning for getenv
-#ifdef _WIN32
-  LoggerGlobals::UsernameDirectory = std::getenv("USERNAME");
-#else
-  LoggerGlobals::UsernameDirectory = std::getenv("USER");
-#endif
-#pragma warning(pop)
   // This is the folder that contains your src files like main.cpp
   LoggerGlobals::SrcProjectDirectory = projectDirectory;
-  // Create Log File and folder
-  LoggerGlobals::LogFolderPath =
-      "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." + gameSaveFolder + "\\logging\\";
-  LoggerGlobals::LogFilePath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                               gameSaveFolder + "\\logging\\" + logFileName + ".log";
-  LoggerGlobals::LogFolderBackupPath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                                       gameSaveFolder + "\\logging\\LogBackup";
-  LoggerGlobals::LogFileBackupPath = "C:\\Users\\" + LoggerGlobals::UsernameDirectory + "\\." +
-                                     gameSaveFolder + "\\logging\\LogBackup\\" + logFileName + "-";
+  // Log folder of the current user, see LoggerFileSystem::defaultLogFolder
+  std::filesystem::path logFolder = LoggerFileSystem::defaultLogFolder(gameSaveFolder);
+  LoggerGlobals::LogFolderPath = (logFolder / "").string();
+  LoggerGlobals::LogFilePath = (logFolder / (logFileName + ".log")).string();
+  LoggerGlobals::LogFolderBackupPath = (logFolder / "LogBackup").string();
+  LoggerGlobals::LogFileBackupPath = (logFolder / "LogBackup" / (logFileName + "-")).string();
+
+  // The logger worker gives way to the render thread when both want the CPU
+  LoggerWorkerOptions workerOptions;
+  workerOptions.niceValue = 5;
+  LoggerThread::GetLoggerThread().SetWorkerOptions(workerOptions);
 
-  LoggerThread::GetLoggerThread().StartLoggerThread(
+  // Folders and the log file are created by the worker while FirstApp is being built
+  LoggerThread::GetLoggerThread().StartLoggerThreadAsync(
       LoggerGlobals::LogFolderPath,
       LoggerGlobals::LogFilePath,
       LoggerGlobals::LogFolderBackupPath,
       LoggerGlobals::LogFileBackupPath);
+
+#ifndef NDEBUG
+  // Debug builds keep a timeline of the LVE_TRACE_SCOPE spans next to the log file
+  std::string tracePath = (logFolder / "trace.json").string();
+  LoggerThread::GetLoggerThread().AddSinkAsync(
+      [tracePath] { return std::make_unique<LoggerTraceSink>(tracePath); });
+  LoggerThread::GetLoggerThread().EnableTracing(true);
+#endif
 }
 
 int main() {